@@ -0,0 +1,43 @@
+#include "./bench.hpp"
+#include "../include/arena_allocator.hpp"
+
+#include <random>
+#include <vector>
+
+// remeshing churn: 4096 sections with meshes of varied size, each step
+// frees one section's range and allocates a new mesh of a different size,
+// the way edits and reloads replace meshes in the chunk arena
+BENCHMARK(arena_replace_4096_sections) {
+    const size_t sections = 4096;
+    ArenaAllocator arena(sections * 8);
+    std::mt19937 random(42);
+    // sizes in 64-vertex blocks, mostly small surface meshes
+    auto size = [&] { return 1 + random() % 8 + (random() % 16 == 0 ? random() % 64 : 0); };
+
+    std::vector<size_t> offsets(sections), sizes(sections);
+    for (size_t i = 0; i < sections; i++) {
+        sizes[i] = size();
+        offsets[i] = arena.allocate(sizes[i]);
+        if (offsets[i] == ArenaAllocator::NONE) {
+            arena.grow(arena.capacity() * 2);
+            offsets[i] = arena.allocate(sizes[i]);
+        }
+    }
+
+    size_t grows = 0;
+    state.run([&] {
+        const size_t i = random() % sections;
+        arena.free(offsets[i], sizes[i]);
+        sizes[i] = size();
+        offsets[i] = arena.allocate(sizes[i]);
+        if (offsets[i] == ArenaAllocator::NONE) {
+            arena.grow(arena.capacity() * 2);
+            offsets[i] = arena.allocate(sizes[i]);
+            grows++;
+        }
+    });
+    state.counter("fragmentation", arena.fragmentation());
+    state.counter("free_ranges", arena.freeRanges());
+    state.counter("occupancy", double(arena.used()) / arena.capacity());
+    state.counter("grows", grows);
+}
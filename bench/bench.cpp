@@ -0,0 +1,155 @@
+#include "./bench.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+struct Entry {
+    const char *name;
+    bench::Function function;
+};
+
+// function-local so registration from other translation units is safe during
+// static initialization
+static std::vector<Entry> &registry() {
+    static std::vector<Entry> entries;
+    return entries;
+}
+
+int bench::add(const char *name, bench::Function function) {
+    registry().push_back({name, function});
+    return registry().size();
+}
+
+double bench::State::percentile(double fraction) const {
+    if (this->samples.empty())
+        return 0.0;
+
+    // nearest rank, so every reported value is a time that was measured
+    std::vector<double> sorted = this->samples;
+    std::sort(sorted.begin(), sorted.end());
+    const size_t rank = (size_t)std::ceil(fraction * sorted.size());
+    return sorted[std::min(std::max(rank, (size_t)1), sorted.size()) - 1];
+}
+
+/* -------------------------------------------------------------------------- */
+// json has no nan or infinity
+static void writeNumber(std::ostream &out, double value) {
+    if (std::isfinite(value))
+        out << value;
+    else
+        out << "null";
+}
+
+// benchmark and counter names are plain identifiers, only quotes and
+// backslashes need escaping
+static void writeString(std::ostream &out, const std::string &value) {
+    out << '"';
+    for (char c : value) {
+        if (c == '"' || c == '\\')
+            out << '\\';
+        out << c;
+    }
+    out << '"';
+}
+
+static void writeJson(std::ostream &out, const std::vector<std::pair<const char *, bench::State>> &results) {
+    out.precision(10);
+    out << "{\n  \"threads\": " << std::thread::hardware_concurrency() << ",\n  \"benchmarks\": [";
+    for (size_t i = 0; i < results.size(); i++) {
+        const bench::State &state = results[i].second;
+        out << (i ? ",\n" : "\n") << "    {\"name\": ";
+        writeString(out, results[i].first);
+        if (state.iterations != 0) {
+            out << ", \"iterations\": " << state.iterations
+                << ", \"samples\": " << state.samples.size()
+                << ", \"ns_per_op\": ";
+            writeNumber(out, state.ns_per_op);
+            out << ", \"min_ns\": ";
+            writeNumber(out, state.percentile(0.0));
+            out << ", \"p50_ns\": ";
+            writeNumber(out, state.percentile(0.5));
+            out << ", \"p90_ns\": ";
+            writeNumber(out, state.percentile(0.9));
+            out << ", \"p99_ns\": ";
+            writeNumber(out, state.percentile(0.99));
+            out << ", \"max_ns\": ";
+            writeNumber(out, state.percentile(1.0));
+        }
+        if (!state.unit.empty()) {
+            out << ", \"throughput\": {\"unit\": ";
+            writeString(out, state.unit);
+            out << ", \"per_second\": ";
+            writeNumber(out, state.units_per_op / (state.ns_per_op * 1e-9));
+            out << "}";
+        }
+        out << ", \"counters\": {";
+        for (size_t c = 0; c < state.counters.size(); c++) {
+            out << (c ? ", " : "");
+            writeString(out, state.counters[c].first);
+            out << ": ";
+            writeNumber(out, state.counters[c].second);
+        }
+        out << "}}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+static void writeText(std::ostream &out, const char *name, const bench::State &state) {
+    out << name;
+    if (state.iterations != 0) {
+        out << "  " << state.ns_per_op << " ns/op (" << state.iterations << " x "
+            << state.samples.size() << " samples, p50 " << state.percentile(0.5)
+            << ", p99 " << state.percentile(0.99) << ")";
+    }
+    out << std::endl;
+
+    if (!state.unit.empty())
+        out << "    " << state.unit << "/s = " << state.units_per_op / (state.ns_per_op * 1e-9) << std::endl;
+    for (auto &counter : state.counters)
+        out << "    " << counter.first << " = " << counter.second << std::endl;
+}
+
+// runs every registered benchmark, or only those whose name contains the
+// filter argument. --json <path> also writes the results as json, "-" for
+// stdout in place of the text report
+int main(int argc, char **argv) {
+    const char *filter = "";
+    const char *json = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--json") && i + 1 < argc)
+            json = argv[++i];
+        else
+            filter = argv[i];
+    }
+    const bool text = !json || strcmp(json, "-");
+
+    std::vector<std::pair<const char *, bench::State>> results;
+    for (const Entry &entry : registry()) {
+        if (!strstr(entry.name, filter))
+            continue;
+
+        bench::State state;
+        entry.function(state);
+        if (text)
+            writeText(std::cout, entry.name, state);
+        results.emplace_back(entry.name, std::move(state));
+    }
+
+    if (!json)
+        return 0;
+    if (!text) {
+        writeJson(std::cout, results);
+        return 0;
+    }
+
+    std::ofstream file(json);
+    if (!file) {
+        std::cout << "ERROR::BENCH::COULD_NOT_WRITE " << json << std::endl;
+        return 1;
+    }
+    writeJson(file, results);
+}
@@ -0,0 +1,97 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace bench {
+
+// handed to every benchmark, collects the timing and any extra counters
+class State {
+public:
+
+    // nanoseconds per call of the last run() body, averaged over every sample
+    double ns_per_op = 0.0;
+    // calls per sample, and the per-call time of each sample in run order
+    uint64_t iterations = 0;
+    std::vector<double> samples;
+    // set by throughput(), reported as units per second
+    std::string unit;
+    double units_per_op = 0.0;
+    std::vector<std::pair<std::string, double>> counters;
+
+    // calls body repeatedly, doubling the batch size until a batch takes
+    // long enough to time reliably, then times batches of that size until
+    // enough time has passed to give stable percentiles. benchmarks slower
+    // than a batch time every call on its own.
+    template <typename F>
+    void run(F &&body) {
+        typedef std::chrono::steady_clock clock;
+        const auto sample_time = std::chrono::milliseconds(10);
+        const auto min_time = std::chrono::milliseconds(200);
+        const size_t min_samples = 5, max_samples = 1000;
+
+        uint64_t n = 1;
+        for (;; n *= 2) {
+            const auto start = clock::now();
+            for (uint64_t i = 0; i < n; i++)
+                body();
+            if (clock::now() - start >= sample_time || n >= (uint64_t(1) << 40))
+                break;
+        }
+
+        this->iterations = n;
+        this->samples.clear();
+        clock::duration total(0);
+        while ((total < min_time || this->samples.size() < min_samples)
+               && this->samples.size() < max_samples) {
+            const auto start = clock::now();
+            for (uint64_t i = 0; i < n; i++)
+                body();
+            const auto elapsed = clock::now() - start;
+            total += elapsed;
+            this->samples.push_back(std::chrono::duration<double, std::nano>(elapsed).count() / n);
+        }
+        this->ns_per_op = std::chrono::duration<double, std::nano>(total).count()
+                        / (n * this->samples.size());
+    }
+
+    // each call of the run() body processes count of unit (blocks,
+    // sections, ticks...)
+    void throughput(const std::string &unit, double count) {
+        this->unit = unit;
+        this->units_per_op = count;
+    }
+
+    // attaches a named value to the report, for results that aren't times
+    void counter(const std::string &name, double value) {
+        this->counters.emplace_back(name, value);
+    }
+
+    // per-call time below which fraction of the samples fall, 0 to 1
+    double percentile(double fraction) const;
+
+};
+
+typedef void (*Function)(State &);
+
+int add(const char *name, Function function);
+
+// keeps the compiler from optimizing away a value the benchmark computed
+template <typename T>
+inline void doNotOptimize(const T &value) {
+    asm volatile("" : : "r"(&value) : "memory");
+}
+
+}
+
+// defines and registers a benchmark function taking a bench::State &state
+#define BENCHMARK(name) \
+    static void name(bench::State &state); \
+    static int name##_registered = bench::add(#name, name); \
+    static void name(bench::State &state)
+
+#endif
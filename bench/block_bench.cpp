@@ -0,0 +1,80 @@
+#include "./bench.hpp"
+#include "../include/block.hpp"
+
+#include <random>
+#include <vector>
+
+// an object-per-block-type registry for comparison: every property of a
+// block in one struct, looked up by id
+struct BlockInfo {
+    const char *name;
+    uint8_t opacity;
+    bool solid;
+    uint8_t emission;
+    uint8_t tile[Block::FACE_COUNT];
+    float texture_offset[Block::FACE_COUNT][2];
+};
+
+static std::vector<BlockInfo> buildInfoTable() {
+    std::vector<BlockInfo> table(Block::BLOCK_COUNT);
+    for (int id = 0; id < Block::BLOCK_COUNT; id++) {
+        table[id].name = "block";
+        table[id].opacity = Block::opacity[id];
+        table[id].solid = Block::solid[id];
+        table[id].emission = Block::emission[id];
+        for (int face = 0; face < Block::FACE_COUNT; face++)
+            table[id].tile[face] = Block::tile[face][id];
+    }
+    return table;
+}
+
+// random pairs of neighbouring ids, weighted towards air and stone like
+// real terrain
+static std::vector<Block::BlockID> randomIds(size_t n) {
+    std::mt19937 rng(3);
+    std::vector<Block::BlockID> ids(n);
+    for (Block::BlockID &id : ids) {
+        const unsigned roll = rng() % 8;
+        id = roll < 3 ? Block::AIR : roll < 6 ? Block::STONE : Block::BlockID(rng() % Block::BLOCK_COUNT);
+    }
+    return ids;
+}
+
+BENCHMARK(block_face_visible_bitset) {
+    const std::vector<Block::BlockID> ids = randomIds(4097);
+    size_t n = 0;
+    state.run([&] {
+        const size_t i = n++ & 4095;
+        bench::doNotOptimize(Block::isFaceVisible(ids[i], ids[i + 1]));
+    });
+}
+
+BENCHMARK(block_face_visible_column) {
+    const std::vector<Block::BlockID> ids = randomIds(4097);
+    size_t n = 0;
+    state.run([&] {
+        const size_t i = n++ & 4095;
+        bench::doNotOptimize(ids[i] != Block::AIR && Block::opacity[ids[i + 1]] != 15 && ids[i] != ids[i + 1]);
+    });
+}
+
+BENCHMARK(block_face_visible_object) {
+    const std::vector<Block::BlockID> ids = randomIds(4097);
+    const std::vector<BlockInfo> table = buildInfoTable();
+    size_t n = 0;
+    state.run([&] {
+        const size_t i = n++ & 4095;
+        const BlockInfo &block = table[ids[i]];
+        const BlockInfo &neighbour = table[ids[i + 1]];
+        bench::doNotOptimize(ids[i] != Block::AIR && neighbour.opacity != 15 && &block != &neighbour);
+    });
+}
+
+BENCHMARK(block_tile_lookup) {
+    const std::vector<Block::BlockID> ids = randomIds(4097);
+    size_t n = 0;
+    state.run([&] {
+        const size_t i = n++ & 4095;
+        bench::doNotOptimize(Block::tile[i % Block::FACE_COUNT][ids[i]]);
+    });
+}
@@ -0,0 +1,85 @@
+#include "./bench.hpp"
+#include "./scenes.hpp"
+#include "../include/chunk.hpp"
+
+#include <memory>
+#include <random>
+
+// the old one-object-per-block layout (a transparency flag and an atlas
+// position), kept to compare against
+struct BlockObject {
+    bool transparent;
+    float texure_location[2];
+};
+
+BENCHMARK(section_memory_terrain) {
+    const int radius = 4;
+    size_t total = 0, mixed_total = 0;
+    int sections = 0, mixed = 0;
+
+    for (int cz = -radius; cz < radius; cz++) {
+        for (int cx = -radius; cx < radius; cx++) {
+            std::unique_ptr<Chunk> chunk(new Chunk(cx, cz));
+            buildTerrain(*chunk);
+
+            total += chunk->memoryUsage();
+            for (const ChunkSection &section : chunk->sections) {
+                sections++;
+                if (!section.isUniform()) {
+                    mixed++;
+                    mixed_total += section.memoryUsage();
+                }
+            }
+        }
+    }
+
+    state.counter("bytes_per_section", double(total) / sections);
+    state.counter("bytes_per_mixed_section", mixed ? double(mixed_total) / mixed : 0.0);
+    state.counter("bytes_per_chunk", double(total) / (4 * radius * radius));
+    state.counter("uniform_section_ratio", double(sections - mixed) / sections);
+    state.counter("block_object_bytes_per_section", double(sizeof(BlockObject)) * SECTION_VOLUME);
+}
+
+BENCHMARK(section_get_random) {
+    std::unique_ptr<Chunk> chunk(new Chunk(0, 0));
+    buildTerrain(*chunk);
+    const ChunkSection &section = chunk->sections[3];
+
+    std::mt19937 rng(1);
+    std::vector<int> indices(4096);
+    for (int &i : indices)
+        i = rng() % SECTION_VOLUME;
+
+    size_t n = 0;
+    state.run([&] {
+        bench::doNotOptimize(section.get(indices[n++ & 4095]));
+    });
+}
+
+BENCHMARK(section_set_random) {
+    ChunkSection section(Block::STONE);
+    const Block::BlockID ids[] = { Block::STONE, Block::DIRT, Block::SAND, Block::AIR };
+
+    std::mt19937 rng(2);
+    std::vector<int> indices(4096);
+    for (int &i : indices)
+        i = rng() % SECTION_VOLUME;
+
+    size_t n = 0;
+    state.run([&] {
+        section.set(indices[n & 4095], ids[(n >> 3) & 3]);
+        n++;
+    });
+}
+
+BENCHMARK(section_unpack) {
+    std::unique_ptr<Chunk> chunk(new Chunk(0, 0));
+    buildTerrain(*chunk);
+    const ChunkSection &section = chunk->sections[3];
+    std::vector<Block::BlockID> blocks(SECTION_VOLUME);
+
+    state.run([&] {
+        section.unpack(blocks.data());
+        bench::doNotOptimize(blocks[0]);
+    });
+}
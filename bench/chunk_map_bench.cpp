@@ -0,0 +1,165 @@
+#include "./bench.hpp"
+#include "../include/chunk_map.hpp"
+#include "../include/world.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+// a loaded world of 10^5 chunks, rows SIDE chunks long. values stand in for
+// the chunk pointers World keeps
+static const int SIDE = 317;
+static const int LOADED = 100000;
+
+typedef ChunkMap<uint64_t> FlatMap;
+typedef std::unordered_map<uint64_t, uint64_t> StdMap;
+
+static uint64_t loadedKey(int i) {
+    return chunkKey(i % SIDE - SIDE / 2, i / SIDE - SIDE / 2);
+}
+
+static const uint64_t *lookup(const FlatMap &map, uint64_t key) {
+    return map.find(key);
+}
+
+static const uint64_t *lookup(const StdMap &map, uint64_t key) {
+    auto it = map.find(key);
+    return it == map.end() ? nullptr : &it->second;
+}
+
+static void add(FlatMap &map, uint64_t key, uint64_t value) {
+    map.insert(key, value);
+}
+
+static void add(StdMap &map, uint64_t key, uint64_t value) {
+    map[key] = value;
+}
+
+template <typename Map>
+static std::unique_ptr<Map> loadedMap() {
+    std::unique_ptr<Map> map(new Map());
+    for (int i = 0; i < LOADED; i++)
+        add(*map, loadedKey(i), uint64_t(i));
+    return map;
+}
+
+// chunks looked up in random order, every one loaded
+template <typename Map>
+static void benchFindRandom(bench::State &state) {
+    std::unique_ptr<Map> map = loadedMap<Map>();
+    std::mt19937 random(7);
+    std::vector<uint64_t> keys(1 << 16);
+    for (uint64_t &key : keys)
+        key = loadedKey(int(random() % LOADED));
+
+    uint64_t sum = 0;
+    state.run([&] {
+        for (uint64_t key : keys)
+            sum += *lookup(*map, key);
+    });
+    bench::doNotOptimize(sum);
+    state.throughput("lookups", keys.size());
+}
+
+BENCHMARK(chunk_map_find_random) {
+    benchFindRandom<FlatMap>(state);
+}
+
+BENCHMARK(chunk_map_find_random_unordered) {
+    benchFindRandom<StdMap>(state);
+}
+
+// chunks just outside the loaded square, as the edges of a mesh or light
+// update ask for
+template <typename Map>
+static void benchFindMissing(bench::State &state) {
+    std::unique_ptr<Map> map = loadedMap<Map>();
+    std::mt19937 random(7);
+    std::vector<uint64_t> keys(1 << 16);
+    for (uint64_t &key : keys) {
+        const int32_t along = int32_t(random() % SIDE) - SIDE / 2;
+        key = random() & 1 ? chunkKey(along, SIDE) : chunkKey(-SIDE, along);
+    }
+
+    size_t found = 0;
+    state.run([&] {
+        for (uint64_t key : keys)
+            found += lookup(*map, key) != nullptr;
+    });
+    bench::doNotOptimize(found);
+    state.throughput("lookups", keys.size());
+}
+
+BENCHMARK(chunk_map_find_missing) {
+    benchFindMissing<FlatMap>(state);
+}
+
+BENCHMARK(chunk_map_find_missing_unordered) {
+    benchFindMissing<StdMap>(state);
+}
+
+// the 3x3 chunks around random chunks, each asked for a row of blocks at a
+// time, the way getBlock() walks a neighbourhood
+template <typename Map>
+static void benchFindNeighbours(bench::State &state) {
+    std::unique_ptr<Map> map = loadedMap<Map>();
+    std::mt19937 random(7);
+    std::vector<uint64_t> keys;
+    for (int centre = 0; centre < 512; centre++) {
+        const int32_t x = int32_t(random() % (SIDE - 2)) - SIDE / 2 + 1;
+        // the last row is only partly loaded
+        const int32_t z = int32_t(random() % (LOADED / SIDE - 2)) - SIDE / 2 + 1;
+        for (int dz = -1; dz <= 1; dz++)
+            for (int dx = -1; dx <= 1; dx++)
+                for (int block = 0; block < SECTION_SIZE; block++)
+                    keys.push_back(chunkKey(x + dx, z + dz));
+    }
+
+    uint64_t sum = 0;
+    state.run([&] {
+        for (uint64_t key : keys)
+            sum += *lookup(*map, key);
+    });
+    bench::doNotOptimize(sum);
+    state.throughput("lookups", keys.size());
+}
+
+BENCHMARK(chunk_map_find_neighbours) {
+    benchFindNeighbours<FlatMap>(state);
+}
+
+BENCHMARK(chunk_map_find_neighbours_unordered) {
+    benchFindNeighbours<StdMap>(state);
+}
+
+// the loaded square sliding one row along as the camera walks, a row
+// unloaded behind and one loaded ahead per call
+template <typename Map>
+static void benchSlide(bench::State &state) {
+    std::unique_ptr<Map> map(new Map());
+    for (int z = 0; z < LOADED / SIDE; z++)
+        for (int x = 0; x < SIDE; x++)
+            add(*map, chunkKey(x, z), uint64_t(x));
+
+    int32_t back = 0;
+    state.run([&] {
+        const int32_t front = back + LOADED / SIDE;
+        for (int x = 0; x < SIDE; x++) {
+            map->erase(chunkKey(x, back));
+            add(*map, chunkKey(x, front), uint64_t(x));
+        }
+        back++;
+    });
+    state.throughput("chunks", 2 * SIDE);
+    state.counter("chunks_loaded", map->size());
+}
+
+BENCHMARK(chunk_map_slide) {
+    benchSlide<FlatMap>(state);
+}
+
+BENCHMARK(chunk_map_slide_unordered) {
+    benchSlide<StdMap>(state);
+}
@@ -0,0 +1,62 @@
+#include "./bench.hpp"
+#include "./scenes.hpp"
+#include "../include/frustum.hpp"
+
+#include <vector>
+
+// every section of a square of chunks radius chunks around the origin
+static void fillBounds(SectionBounds &bounds, int radius) {
+    for (int x = -radius; x < radius; x++)
+        for (int z = -radius; z < radius; z++)
+            for (int y = 0; y < CHUNK_SECTIONS; y++)
+                bounds.insert({ x, y, z });
+}
+
+static void benchCull(bench::State &state, int radius) {
+    float clip[16];
+    cameraMatrix(0.0f, 80.0f, 0.0f, 0.0f, 0.0f, clip);
+    const Frustum frustum(clip);
+
+    SectionBounds bounds;
+    fillBounds(bounds, radius);
+
+    std::vector<SectionPos> visible;
+    visible.reserve(bounds.size());
+    state.run([&] {
+        visible.clear();
+        bounds.cull(frustum, visible);
+        bench::doNotOptimize(visible.data());
+    });
+    state.counter("sections", bounds.size());
+    state.counter("visible", visible.size());
+}
+
+BENCHMARK(frustum_cull_16k_sections) { benchCull(state, 16); }
+BENCHMARK(frustum_cull_65k_sections) { benchCull(state, 32); }
+
+// the same 65k sections one box at a time, for comparison
+BENCHMARK(frustum_test_box_65k_sections) {
+    float clip[16];
+    cameraMatrix(0.0f, 80.0f, 0.0f, 0.0f, 0.0f, clip);
+    const Frustum frustum(clip);
+
+    std::vector<SectionPos> sections;
+    for (int x = -32; x < 32; x++)
+        for (int z = -32; z < 32; z++)
+            for (int y = 0; y < CHUNK_SECTIONS; y++)
+                sections.push_back({ x, y, z });
+
+    size_t visible = 0;
+    state.run([&] {
+        visible = 0;
+        for (const SectionPos &pos : sections) {
+            const float min[3] = { float(pos.x * SECTION_SIZE), float(pos.y * SECTION_SIZE),
+                                   float(pos.z * SECTION_SIZE) };
+            const float max[3] = { min[0] + SECTION_SIZE, min[1] + SECTION_SIZE,
+                                   min[2] + SECTION_SIZE };
+            visible += frustum.testBox(min, max);
+        }
+        bench::doNotOptimize(&visible);
+    });
+    state.counter("visible", visible);
+}
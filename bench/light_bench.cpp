@@ -0,0 +1,117 @@
+#include "./bench.hpp"
+#include "../include/job_system.hpp"
+#include "../include/light_engine.hpp"
+#include "../include/terrain.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <thread>
+
+// a square of generated chunks radius chunks around the origin, lit
+// unless told otherwise
+struct LitWorld {
+    World world;
+    TerrainGenerator terrain;
+    LightEngine light;
+
+    explicit LitWorld(int radius, bool lit = true) : terrain(1337), light(world) {
+        for (int x = -radius; x < radius; x++)
+            for (int z = -radius; z < radius; z++)
+                this->terrain.generate(this->world.createChunk(x, z));
+        if (lit) {
+            for (int x = -radius; x < radius; x++)
+                for (int z = -radius; z < radius; z++)
+                    this->light.lightChunk(x, z);
+        }
+        this->world.takeDirty();
+    }
+};
+
+static std::vector<ChunkPos> chunksAround(int radius) {
+    std::vector<ChunkPos> chunks;
+    for (int x = -radius; x < radius; x++)
+        for (int z = -radius; z < radius; z++)
+            chunks.push_back({ x, z });
+    return chunks;
+}
+
+// relights a chunk surrounded by lit neighbours, as when it streams in
+BENCHMARK(light_chunk_terrain) {
+    std::unique_ptr<LitWorld> scene(new LitWorld(2));
+    state.run([&] {
+        scene->light.lightChunk(0, 0);
+    });
+    state.throughput("chunks", 1);
+}
+
+// one edit and its relight per call, undone by the next call
+static void benchEdit(bench::State &state, Block::BlockID id, int above_ground) {
+    std::unique_ptr<LitWorld> scene(new LitWorld(2));
+    const int x = 8, z = 8;
+    const int y = scene->terrain.height(x, z) + above_ground;
+    const Block::BlockID original = scene->world.getBlock(x, y, z);
+
+    bool placed = false;
+    size_t relit = 0, edits = 0;
+    state.run([&] {
+        placed = !placed;
+        scene->world.setBlock(x, y, z, placed ? id : original);
+        scene->light.blockChanged(x, y, z);
+        relit += scene->light.update();
+        edits++;
+    });
+    state.counter("relit_blocks_per_edit", double(relit) / edits);
+}
+
+// a block placed and removed over open ground, shading the column below
+BENCHMARK(light_edit_shadow) { benchEdit(state, Block::STONE, 2); }
+// an emitter placed and removed in the open, the largest area one edit
+// can light
+BENCHMARK(light_edit_emitter) { benchEdit(state, Block::LAVA, 2); }
+// the surface block dug out and put back
+BENCHMARK(light_edit_dig) { benchEdit(state, Block::AIR, 0); }
+
+BENCHMARK(light_memory) {
+    std::unique_ptr<LitWorld> scene(new LitWorld(2));
+    size_t bytes = 0, uniform = 0, sections = 0;
+    for (int x = -2; x < 2; x++) {
+        for (int z = -2; z < 2; z++) {
+            const Chunk *chunk = scene->world.getChunk(x, z);
+            for (const LightSection &light : chunk->light) {
+                bytes += light.memoryUsage();
+                uniform += light.sky.isUniform() + light.block.isUniform();
+                sections++;
+            }
+        }
+    }
+    state.counter("light_bytes_per_section", double(bytes) / sections);
+    state.counter("uniform_array_percent", 50.0 * uniform / sections);
+}
+
+// relights a square of chunks through lightChunks() and reports chunks per
+// second for a growing number of workers. the calling thread lights too
+BENCHMARK(light_parallel_scaling) {
+    const int radius = 4;
+    std::unique_ptr<LitWorld> scene(new LitWorld(radius));
+    const std::vector<ChunkPos> chunks = chunksAround(radius);
+
+    state.run([&] {
+        for (const ChunkPos &pos : chunks)
+            scene->light.lightChunk(pos.x, pos.z);
+        scene->world.takeDirty();
+    });
+    state.counter("chunks_per_second_serial", chunks.size() / (state.ns_per_op * 1e-9));
+
+    const unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned threads = 1; threads <= hardware; threads *= 2) {
+        JobSystem jobs(threads);
+        state.run([&] {
+            scene->light.lightChunks(chunks, jobs);
+            scene->world.takeDirty();
+        });
+        state.counter("chunks_per_second_" + std::to_string(threads) + "_workers",
+                      chunks.size() / (state.ns_per_op * 1e-9));
+    }
+    state.throughput("chunks", chunks.size());
+}
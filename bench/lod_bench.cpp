@@ -0,0 +1,72 @@
+#include "./bench.hpp"
+#include "./scenes.hpp"
+#include "../include/lod.hpp"
+#include "../include/mesher.hpp"
+
+#include <memory>
+
+static const ChunkSection *const no_neighbours[Block::FACE_COUNT] = {};
+
+static void benchDownsample(bench::State &state, int lod) {
+    ChunkSection section;
+    fillTerrain(section);
+
+    std::unique_ptr<PaddedSection> padded(new PaddedSection);
+    ChunkMesh mesh;
+    state.run([&] {
+        padded->load(section, no_neighbours);
+        if (lod > 0)
+            padded->downsample(lodScale(lod), 0, no_neighbours);
+        greedyMesh(*padded, mesh);
+        bench::doNotOptimize(mesh.vertices.data());
+    });
+    state.counter("quads", mesh.quads());
+}
+
+BENCHMARK(lod0_load_and_mesh_terrain) { benchDownsample(state, 0); }
+BENCHMARK(lod1_load_and_mesh_terrain) { benchDownsample(state, 1); }
+BENCHMARK(lod2_load_and_mesh_terrain) { benchDownsample(state, 2); }
+
+// quads drawn for a square of terrain chunks radius chunks around the
+// camera, once at full detail and once with the selector's levels. with
+// levels the count grows roughly with the radius rather than its square
+static void benchViewQuads(bench::State &state, int radius) {
+    Chunk chunk(0, 0);
+    buildTerrain(chunk);
+
+    std::unique_ptr<PaddedSection> padded(new PaddedSection);
+    ChunkMesh mesh;
+    size_t quads[LOD_LEVELS];
+    for (int lod = 0; lod < LOD_LEVELS; lod++) {
+        quads[lod] = 0;
+        for (int y = 0; y < CHUNK_SECTIONS; y++) {
+            padded->load(chunk.sections[y], no_neighbours);
+            if (lod > 0)
+                padded->downsample(lodScale(lod), 0, no_neighbours);
+            greedyMesh(*padded, mesh);
+            quads[lod] += mesh.quads();
+        }
+    }
+
+    LodSelector lods;
+    std::vector<SectionPos> changed;
+    size_t full = 0, reduced = 0;
+    state.run([&] {
+        lods.clear();
+        lods.update(8.0f, 80.0f, 8.0f, changed);
+        full = reduced = 0;
+        for (int x = -radius; x < radius; x++) {
+            for (int z = -radius; z < radius; z++) {
+                full += quads[0];
+                reduced += quads[lods.level({ x, 4, z })];
+            }
+        }
+        bench::doNotOptimize(&reduced);
+    });
+    state.counter("full_quads", full);
+    state.counter("lod_quads", reduced);
+}
+
+BENCHMARK(lod_view_quads_radius_8)  { benchViewQuads(state, 8); }
+BENCHMARK(lod_view_quads_radius_16) { benchViewQuads(state, 16); }
+BENCHMARK(lod_view_quads_radius_32) { benchViewQuads(state, 32); }
@@ -0,0 +1,214 @@
+#include "./bench.hpp"
+#include "./scenes.hpp"
+#include "../include/fixed_timestep.hpp"
+#include "../include/light_engine.hpp"
+#include "../include/lod.hpp"
+#include "../include/mesh_scheduler.hpp"
+#include "../include/mesher.hpp"
+#include "../include/terrain.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+// whole-pipeline benchmarks, each timing one stage of the game over a full
+// world instead of a single section, so a regression anywhere in the stage
+// shows up even if no microbenchmark covers it
+
+// fills a square of chunks radius chunks around the origin
+static void generateWorld(World &world, int radius) {
+    for (int x = -radius; x < radius; x++) {
+        for (int z = -radius; z < radius; z++) {
+            Chunk &chunk = world.createChunk(x, z);
+            buildTerrain(chunk);
+            carveCaves(chunk);
+        }
+    }
+}
+
+BENCHMARK(macro_generate_world) {
+    const int radius = 4;
+    const TerrainGenerator terrain(WORLD_SEED);
+    state.run([&] {
+        World world;
+        for (int x = -radius; x < radius; x++)
+            for (int z = -radius; z < radius; z++)
+                terrain.generate(world.createChunk(x, z));
+        bench::doNotOptimize(world.chunkCount());
+    });
+    state.throughput("chunks", 4 * radius * radius);
+}
+
+// sky and block light for every chunk of a freshly generated world
+BENCHMARK(macro_light_world) {
+    const int radius = 4;
+    const TerrainGenerator terrain(WORLD_SEED);
+    World world;
+    for (int x = -radius; x < radius; x++)
+        for (int z = -radius; z < radius; z++)
+            terrain.generate(world.createChunk(x, z));
+
+    LightEngine light(world);
+    state.run([&] {
+        for (int x = -radius; x < radius; x++)
+            for (int z = -radius; z < radius; z++)
+                light.lightChunk(x, z);
+    });
+    state.throughput("chunks", 4 * radius * radius);
+}
+
+// every section of a lit world meshed on this thread with its real
+// neighbours and light, as the mesh jobs do it
+BENCHMARK(macro_mesh_world) {
+    const int radius = 3;
+    World world;
+    generateWorld(world, radius);
+    LightEngine light(world);
+    for (int x = -radius; x < radius; x++)
+        for (int z = -radius; z < radius; z++)
+            light.lightChunk(x, z);
+    world.takeDirty();
+
+    std::vector<SectionPos> sections;
+    for (int x = -radius; x < radius; x++)
+        for (int z = -radius; z < radius; z++)
+            for (int y = 0; y < CHUNK_SECTIONS; y++)
+                sections.push_back({ x, y, z });
+
+    std::unique_ptr<PaddedSection> padded(new PaddedSection);
+    ChunkMesh mesh;
+    size_t quads = 0;
+    state.run([&] {
+        quads = 0;
+        for (const SectionPos &pos : sections) {
+            const ChunkSection *around[PaddedSection::NEIGHBOURHOOD];
+            const LightSection *around_light[PaddedSection::NEIGHBOURHOOD];
+            for (int dy = -1; dy <= 1; dy++) {
+                for (int dz = -1; dz <= 1; dz++) {
+                    for (int dx = -1; dx <= 1; dx++) {
+                        const SectionPos at = { pos.x + dx, pos.y + dy, pos.z + dz };
+                        around[PaddedSection::around(dx, dy, dz)] = world.getSection(at);
+                        around_light[PaddedSection::around(dx, dy, dz)] = world.getLight(at);
+                    }
+                }
+            }
+            padded->load(around);
+            padded->loadLight(around_light);
+            binaryMesh(*padded, mesh);
+            quads += mesh.quads();
+        }
+        bench::doNotOptimize(&quads);
+    });
+    state.throughput("sections", sections.size());
+    state.counter("quads", quads);
+}
+
+// one frame of visibility work per call for a camera flying a circle over
+// the caves: level of detail, frustum, then occlusion
+BENCHMARK(macro_cull_flight) {
+    static std::unique_ptr<CaveWorld> scene(new CaveWorld(16));
+    const int frames = 256;
+
+    LodSelector lods;
+    std::vector<SectionPos> changed, visible;
+    size_t frame = 0, drawn = 0, lod_changes = 0;
+    state.run([&] {
+        const float angle = float(frame++ % frames) / frames * 6.2831853f;
+        const float x = 120.0f * std::cos(angle), z = 120.0f * std::sin(angle);
+        const float y = 80.0f;
+
+        changed.clear();
+        lods.update(x, y, z, changed);
+        lod_changes += changed.size();
+
+        float clip[16];
+        cameraMatrix(x, y, z, angle * 57.29578f + 90.0f, -15.0f, clip);
+        const Frustum frustum(clip);
+        const SectionPos start = { int32_t(std::floor(x / SECTION_SIZE)), int32_t(std::floor(y / SECTION_SIZE)),
+                                   int32_t(std::floor(z / SECTION_SIZE)) };
+
+        visible.clear();
+        scene->bounds.cull(frustum, visible);
+        scene->graph.traverse(start, frustum);
+        visible.erase(std::remove_if(visible.begin(), visible.end(),
+            [&](const SectionPos &pos) { return !scene->graph.reached(pos); }), visible.end());
+        drawn += visible.size();
+        // Window asks for the level of every section it meshes
+        for (const SectionPos &pos : visible)
+            bench::doNotOptimize(lods.level(pos));
+    });
+    state.throughput("frames", 1);
+    state.counter("drawn_per_frame", double(drawn) / frame);
+    state.counter("lod_changes_per_frame", double(lod_changes) / frame);
+}
+
+// there is no save format yet, so this times the round trip any format would
+// make through a section's flat block array: unpack on save, assign on load
+BENCHMARK(macro_serialize_world) {
+    const int radius = 4;
+    World world;
+    generateWorld(world, radius);
+
+    std::unique_ptr<Chunk> copy(new Chunk(0, 0));
+    std::vector<Block::BlockID> blocks(SECTION_VOLUME);
+    size_t sections = 0;
+    state.run([&] {
+        sections = 0;
+        for (int x = -radius; x < radius; x++) {
+            for (int z = -radius; z < radius; z++) {
+                const Chunk *chunk = world.getChunk(x, z);
+                for (int y = 0; y < CHUNK_SECTIONS; y++) {
+                    chunk->sections[y].unpack(blocks.data());
+                    copy->sections[y].assign(blocks.data());
+                    sections++;
+                }
+            }
+        }
+        bench::doNotOptimize(copy->sections[0].paletteSize());
+    });
+    state.throughput("blocks", double(sections) * SECTION_VOLUME);
+}
+
+// the main thread's share of a frame at 60 fps: fixed ticks that dig and
+// place blocks near the player, then the new sections handed to the mesh
+// workers and finished meshes drained under the upload budget
+BENCHMARK(macro_tick_loop) {
+    const int radius = 3;
+    World world;
+    generateWorld(world, radius);
+    world.takeDirty();
+
+    JobSystem jobs(std::max(1u, std::thread::hardware_concurrency() - 1));
+    MeshScheduler meshes(jobs);
+    FixedTimestep timestep(TICKS_PER_SECOND, MAX_TICKS_PER_FRAME);
+    timestep.reset(0);
+
+    std::mt19937 rng(9);
+    const uint64_t frame_ns = 16666667;
+    uint64_t now = 0, ticks = 0, frames = 0, uploaded = 0;
+    state.run([&] {
+        now += frame_ns;
+        frames++;
+        for (uint32_t tick = timestep.advance(now); tick > 0; tick--) {
+            ticks++;
+            for (int edit = 0; edit < 4; edit++) {
+                const int x = int(rng() % 32) - 16, z = int(rng() % 32) - 16;
+                const int y = 56 + int(rng() % 16);
+                world.setBlock(x, y, z, world.getBlock(x, y, z) == Block::AIR ? Block::COBBLESTONE : Block::AIR);
+            }
+        }
+        for (const SectionPos &pos : world.takeDirty())
+            meshes.schedule(world, pos);
+        uploaded += meshes.drain(UPLOAD_BUDGET_NS, [](MeshResult &) {});
+    });
+    while (meshes.inFlight() != 0) {
+        if (meshes.drain(UINT64_MAX, [](MeshResult &) {}) == 0)
+            std::this_thread::yield();
+    }
+    state.throughput("frames", 1);
+    state.counter("ticks_per_frame", double(ticks) / frames);
+    state.counter("meshes_per_frame", double(uploaded) / frames);
+}
@@ -0,0 +1,41 @@
+#include "./bench.hpp"
+#include "./scenes.hpp"
+#include "../include/mesh_scheduler.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+// meshes every section of a block of terrain chunks through the job system
+// and reports sections per second for a growing number of workers
+BENCHMARK(mesh_scheduler_throughput) {
+    const int radius = 3;
+    World world;
+    for (int z = -radius; z < radius; z++) {
+        for (int x = -radius; x < radius; x++) {
+            buildTerrain(world.createChunk(x, z));
+            world.markChunkDirty(x, z);
+        }
+    }
+    const std::vector<SectionPos> sections = world.takeDirty();
+
+    const unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned threads = 1; threads <= hardware; threads *= 2) {
+        JobSystem jobs(threads);
+        MeshScheduler meshes(jobs);
+
+        size_t meshed = 0;
+        state.run([&] {
+            for (const SectionPos &pos : sections)
+                meshes.schedule(world, pos);
+            while (meshes.inFlight() != 0) {
+                if (meshes.drain(UINT64_MAX, [&](MeshResult &) { meshed++; }) == 0)
+                    std::this_thread::yield();
+            }
+        });
+
+        state.counter("sections_per_second_" + std::to_string(threads) + "_threads",
+                      sections.size() / (state.ns_per_op * 1e-9));
+    }
+}
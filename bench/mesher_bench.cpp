@@ -0,0 +1,78 @@
+#include "./bench.hpp"
+#include "./scenes.hpp"
+#include "../include/mesher.hpp"
+
+#include <memory>
+
+static const ChunkSection *const no_neighbours[Block::FACE_COUNT] = {};
+
+typedef void (*Mesher)(const PaddedSection &, ChunkMesh &);
+
+static void benchMesher(bench::State &state, Mesher mesher, void (*scene)(ChunkSection &), bool smooth = true) {
+    ChunkSection section;
+    scene(section);
+
+    std::unique_ptr<PaddedSection> padded(new PaddedSection);
+    padded->load(section, no_neighbours);
+    padded->smooth = smooth;
+
+    ChunkMesh mesh;
+    state.run([&] {
+        mesher(*padded, mesh);
+        bench::doNotOptimize(mesh.vertices.data());
+    });
+    state.counter("quads", mesh.quads());
+    state.counter("vertex_bytes", mesh.vertices.size() * sizeof(ChunkVertex));
+}
+
+static void randomScene(ChunkSection &section) {
+    fillRandom(section, 7);
+}
+
+BENCHMARK(culled_mesh_terrain)      { benchMesher(state, culledMesh, fillTerrain); }
+BENCHMARK(culled_mesh_random)       { benchMesher(state, culledMesh, randomScene); }
+BENCHMARK(culled_mesh_checkerboard) { benchMesher(state, culledMesh, fillCheckerboard); }
+
+BENCHMARK(greedy_mesh_terrain)      { benchMesher(state, greedyMesh, fillTerrain); }
+BENCHMARK(greedy_mesh_random)       { benchMesher(state, greedyMesh, randomScene); }
+BENCHMARK(greedy_mesh_checkerboard) { benchMesher(state, greedyMesh, fillCheckerboard); }
+
+BENCHMARK(binary_mesh_terrain)      { benchMesher(state, binaryMesh, fillTerrain); }
+BENCHMARK(binary_mesh_random)       { benchMesher(state, binaryMesh, randomScene); }
+BENCHMARK(binary_mesh_checkerboard) { benchMesher(state, binaryMesh, fillCheckerboard); }
+
+// without corner shading, which faces merge across and what it costs
+BENCHMARK(binary_mesh_terrain_flat) { benchMesher(state, binaryMesh, fillTerrain, false); }
+BENCHMARK(binary_mesh_random_flat)  { benchMesher(state, binaryMesh, randomScene, false); }
+
+BENCHMARK(padded_section_load) {
+    ChunkSection section, neighbour;
+    fillTerrain(section);
+    fillRandom(neighbour, 8);
+    const ChunkSection *const neighbours[Block::FACE_COUNT] = {
+        &neighbour, &neighbour, &neighbour, &neighbour, &neighbour, &neighbour
+    };
+
+    std::unique_ptr<PaddedSection> padded(new PaddedSection);
+    state.run([&] {
+        padded->load(section, neighbours);
+        bench::doNotOptimize(padded->blocks[0]);
+    });
+}
+
+// light of a section and its border from neighbours with a lit surface
+BENCHMARK(padded_section_load_light) {
+    LightSection lit, dark;
+    lit.sky.fill(15);
+    for (int i = 0; i < SECTION_VOLUME; i += 3)
+        lit.sky.set(i, uint8_t(i % 16));
+    const LightSection *light[PaddedSection::NEIGHBOURHOOD];
+    for (int slot = 0; slot < PaddedSection::NEIGHBOURHOOD; slot++)
+        light[slot] = slot % 2 ? &lit : &dark;
+
+    std::unique_ptr<PaddedSection> padded(new PaddedSection);
+    state.run([&] {
+        padded->loadLight(light);
+        bench::doNotOptimize(padded->light[0]);
+    });
+}
@@ -0,0 +1,72 @@
+#include "./bench.hpp"
+#include "../include/profiler.hpp"
+
+#include <cstdint>
+#include <sstream>
+#include <vector>
+
+// cost of one PROFILE_ZONE, draining the buffer often enough that it never
+// fills and starts dropping events
+BENCHMARK(profile_zone_overhead) {
+    uint64_t n = 0;
+    state.run([&] {
+        {
+            PROFILE_ZONE("bench zone");
+        }
+        if ((++n & 4095) == 0)
+            Profiler::endFrame();
+    });
+    Profiler::endFrame();
+}
+
+BENCHMARK(profile_count_overhead) {
+    uint64_t n = 0;
+    state.run([&] {
+        PROFILE_COUNT("bench counter", 1);
+        if ((++n & 4095) == 0)
+            Profiler::endFrame();
+    });
+    Profiler::endFrame();
+}
+
+// folding a busy frame's worth of events into the per-frame history
+BENCHMARK(profile_end_frame_4096_events) {
+    state.run([&] {
+        for (int i = 0; i < 4096; i++) {
+            PROFILE_ZONE("bench frame zone");
+        }
+        Profiler::endFrame();
+    });
+}
+
+// the same frame with a trace capture running, the difference is the
+// capture overhead
+BENCHMARK(profile_end_frame_4096_events_capturing) {
+    uint64_t n = 0;
+    state.run([&] {
+        // restart now and then so the capture doesn't grow without bound
+        if ((n++ & 63) == 0)
+            Profiler::startCapture(UINT32_MAX, "");
+        for (int i = 0; i < 4096; i++) {
+            PROFILE_ZONE("bench frame zone");
+        }
+        Profiler::endFrame();
+    });
+    Profiler::startCapture(0, "");
+}
+
+// serializing a captured frame of 4096 zones
+BENCHMARK(profile_write_trace_4096_events) {
+    std::vector<ProfileEvent> events(4096);
+    std::vector<uint32_t> threads(4096, 0);
+    const uint16_t id = Profiler::zone("bench trace zone");
+    for (size_t i = 0; i < events.size(); i++)
+        events[i] = { i * 1000, i * 1000 + 500, id, ProfileEvent::ZONE };
+
+    std::ostringstream out;
+    state.run([&] {
+        out.str("");
+        Profiler::writeTrace(out, events, threads, 0);
+    });
+    state.counter("bytes_per_event", double(out.str().size()) / events.size());
+}
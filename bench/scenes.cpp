@@ -0,0 +1,141 @@
+#include "./scenes.hpp"
+
+#include <cmath>
+#include <memory>
+#include <random>
+
+void buildTerrain(Chunk &chunk) {
+    const int sea_level = 62;
+
+    for (int z = 0; z < SECTION_SIZE; z++) {
+        for (int x = 0; x < SECTION_SIZE; x++) {
+            const float wx = chunk.x * SECTION_SIZE + x;
+            const float wz = chunk.z * SECTION_SIZE + z;
+            const int height = 64 + 6 * std::sin(wx * 0.07f) + 5 * std::cos(wz * 0.05f)
+                             + 2 * std::sin((wx + wz) * 0.21f);
+
+            for (int y = 0; y < CHUNK_HEIGHT; y++) {
+                Block::BlockID id = Block::AIR;
+                if (y < height - 4)
+                    id = Block::STONE;
+                else if (y < height)
+                    id = height <= sea_level + 1 ? Block::SAND : Block::DIRT;
+                else if (y == height)
+                    id = height <= sea_level + 1 ? Block::SAND : Block::GRASS;
+                else if (y <= sea_level)
+                    id = Block::WATER;
+
+                if (id != Block::AIR)
+                    chunk.set(x, y, z, id);
+            }
+        }
+    }
+}
+
+void carveCaves(Chunk &chunk) {
+    for (int z = 0; z < SECTION_SIZE; z++) {
+        for (int x = 0; x < SECTION_SIZE; x++) {
+            const float wx = chunk.x * SECTION_SIZE + x;
+            const float wz = chunk.z * SECTION_SIZE + z;
+            for (int y = 8; y < 48; y++) {
+                // two families of tubes crossing at different depths
+                const float a = std::sin(wx * 0.09f + y * 0.05f) + std::cos(wz * 0.11f);
+                const float b = std::sin(wz * 0.08f - y * 0.04f) + std::cos(wx * 0.13f + 1.7f);
+                const float band = std::sin(y * 0.25f);
+                if ((std::fabs(a) < 0.12f || std::fabs(b) < 0.12f) && band > -0.2f)
+                    chunk.set(x, y, z, Block::AIR);
+            }
+        }
+    }
+}
+
+CaveWorld::CaveWorld(int radius) {
+    for (int x = -radius; x < radius; x++) {
+        for (int z = -radius; z < radius; z++) {
+            Chunk &chunk = this->world.createChunk(x, z);
+            buildTerrain(chunk);
+            carveCaves(chunk);
+            for (int y = 0; y < CHUNK_SECTIONS; y++) {
+                const SectionPos pos = { x, y, z };
+                this->graph.set(pos, sectionConnections(chunk.sections[y]));
+                // what the mesher would give a mesh: anything not all one
+                // block
+                if (!chunk.sections[y].isUniform())
+                    this->bounds.insert(pos);
+            }
+        }
+    }
+}
+
+void fillTerrain(ChunkSection &section) {
+    std::unique_ptr<Chunk> chunk(new Chunk(0, 0));
+    buildTerrain(*chunk);
+    section = chunk->sections[64 / SECTION_SIZE];
+}
+
+void fillRandom(ChunkSection &section, uint32_t seed, float density) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> roll(0.0f, 1.0f);
+    Block::BlockID blocks[SECTION_VOLUME];
+    for (Block::BlockID &block : blocks)
+        block = roll(rng) < density ? Block::STONE : Block::AIR;
+    section.assign(blocks);
+}
+
+void fillCheckerboard(ChunkSection &section) {
+    Block::BlockID blocks[SECTION_VOLUME];
+    for (int y = 0; y < SECTION_SIZE; y++)
+        for (int z = 0; z < SECTION_SIZE; z++)
+            for (int x = 0; x < SECTION_SIZE; x++)
+                blocks[ChunkSection::index(x, y, z)] = ((x + y + z) & 1) ? Block::STONE : Block::AIR;
+    section.assign(blocks);
+}
+
+void cameraMatrix(float x, float y, float z, float yaw, float pitch, float *out) {
+    const float radians = 3.14159265f / 180.0f;
+    const float fov = 45.0f * radians;
+    const float aspect = 16.0f / 9.0f, near = 0.1f, far = 1000.0f;
+    const float f = 1.0f / std::tan(fov / 2.0f);
+
+    float projection[16] = {};
+    projection[0] = f / aspect;
+    projection[5] = f;
+    projection[10] = (far + near) / (near - far);
+    projection[11] = -1.0f;
+    projection[14] = 2.0f * far * near / (near - far);
+
+    // forward, right = forward x up, and the camera's true up
+    const float fw[3] = { std::cos(yaw * radians) * std::cos(pitch * radians),
+                          std::sin(pitch * radians),
+                          std::sin(yaw * radians) * std::cos(pitch * radians) };
+    float rt[3] = { -fw[2], 0.0f, fw[0] };
+    const float length = std::sqrt(rt[0] * rt[0] + rt[2] * rt[2]);
+    rt[0] /= length;
+    rt[2] /= length;
+    const float up[3] = { rt[1] * fw[2] - rt[2] * fw[1],
+                          rt[2] * fw[0] - rt[0] * fw[2],
+                          rt[0] * fw[1] - rt[1] * fw[0] };
+    const float eye[3] = { x, y, z };
+
+    float view[16] = {};
+    for (int i = 0; i < 3; i++) {
+        view[i * 4 + 0] = rt[i];
+        view[i * 4 + 1] = up[i];
+        view[i * 4 + 2] = -fw[i];
+    }
+    for (int i = 0; i < 3; i++) {
+        view[12] -= rt[i] * eye[i];
+        view[13] -= up[i] * eye[i];
+        view[14] += fw[i] * eye[i];
+    }
+    view[15] = 1.0f;
+
+    for (int c = 0; c < 4; c++) {
+        for (int r = 0; r < 4; r++) {
+            float sum = 0.0f;
+            for (int k = 0; k < 4; k++)
+                sum += projection[k * 4 + r] * view[c * 4 + k];
+            out[c * 4 + r] = sum;
+        }
+    }
+}
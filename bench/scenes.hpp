@@ -0,0 +1,44 @@
+#ifndef BENCH_SCENES_H
+#define BENCH_SCENES_H
+
+#include <cstdint>
+#include "../include/chunk.hpp"
+#include "../include/frustum.hpp"
+#include "../include/visibility.hpp"
+#include "../include/world.hpp"
+
+// reproducible block layouts shared by the benchmarks
+
+// winding tunnels through the stone under buildTerrain's surface
+void carveCaves(Chunk &chunk);
+
+// rolling hills around sea level: stone, a few blocks of dirt capped with
+// grass, sand on the shore and water filling anything below sea level
+void buildTerrain(Chunk &chunk);
+
+// the surface section of buildTerrain for chunk (0, 0)
+void fillTerrain(ChunkSection &section);
+
+// each block is stone with the given probability, otherwise air
+void fillRandom(ChunkSection &section, uint32_t seed, float density = 0.5f);
+
+// alternating stone and air, the worst case for every mesher
+void fillCheckerboard(ChunkSection &section);
+
+// buildTerrain plus carveCaves for a square of chunks radius chunks around
+// the origin, with the culling structures Window keeps for it
+struct CaveWorld {
+    World world;
+    VisibilityGraph graph;
+    SectionBounds bounds;
+
+    explicit CaveWorld(int radius);
+};
+
+// column-major projection * view matrix, as glm::perspective (45 degree
+// fov, 16:9, far plane 1000) and glm::lookAt would build it, for a camera
+// at (x, y, z). yaw turns from +x towards +z, pitch up from level, both in
+// degrees
+void cameraMatrix(float x, float y, float z, float yaw, float pitch, float *out);
+
+#endif
@@ -0,0 +1,148 @@
+#include "./bench.hpp"
+#include "../include/chunk_manager.hpp"
+#include "../include/clock.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <thread>
+
+// a world streamed around a camera. members are declared so the manager
+// goes before the job system and the job system before the world
+struct Streamer {
+    World world;
+    TerrainGenerator terrain;
+    LightEngine light;
+    JobSystem jobs;
+    ChunkManager manager;
+
+    float x = 0.0f, z = 0.0f, dir_x = 0.0f, dir_z = 1.0f;
+    size_t sections = 0;
+    // the slowest frame() so far
+    uint64_t max_frame_ns = 0;
+
+    explicit Streamer(int radius) : terrain(1337), light(world),
+                                    jobs(std::max(2u, std::thread::hardware_concurrency())),
+                                    manager(world, light, terrain, jobs, radius) {}
+
+    // one frame as Window::update() runs it, minus the meshing
+    void frame() {
+        const uint64_t start = monotonicNs();
+        std::vector<ChunkPos> unloaded;
+        this->manager.update(this->x, float(TerrainGenerator::SEA_LEVEL), this->z,
+                             this->dir_x, this->dir_z, unloaded);
+        this->sections += this->manager.takeDirty().size();
+        this->max_frame_ns = std::max(this->max_frame_ns, monotonicNs() - start);
+    }
+
+    // chunks in range of the camera's chunk
+    static size_t inRange(int radius) {
+        size_t count = 0;
+        for (int dz = -radius; dz <= radius; dz++)
+            for (int dx = -radius; dx <= radius; dx++)
+                count += dx * dx + dz * dz <= radius * radius;
+        return count;
+    }
+
+    // whether every chunk within radius chunks and 60 degrees of the view
+    // direction can be meshed
+    bool viewReady(int radius) const {
+        const int32_t cx = int32_t(std::floor(this->x / SECTION_SIZE));
+        const int32_t cz = int32_t(std::floor(this->z / SECTION_SIZE));
+        for (int dz = -radius; dz <= radius; dz++) {
+            for (int dx = -radius; dx <= radius; dx++) {
+                const float distance = std::sqrt(float(dx * dx + dz * dz));
+                if (distance > radius)
+                    continue;
+                const bool visible = distance < 1.0f || (dx * this->dir_x + dz * this->dir_z) / distance >= 0.5f;
+                if (visible && !this->manager.ready(cx + dx, cz + dz))
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    // runs frames until every chunk in range is ready, yielding to the
+    // workers in between. returns the frames taken
+    size_t fill(int radius) {
+        size_t frames = 0;
+        while (this->manager.readyCount() < this->inRange(radius)) {
+            this->frame();
+            frames++;
+            std::this_thread::yield();
+        }
+        return frames;
+    }
+};
+
+// streams a world in from nothing until every chunk in range can be meshed
+BENCHMARK(streaming_fill_radius) {
+    const int radius = 6;
+    size_t frames = 0, sections = 0, chunks = 0;
+    state.run([&] {
+        std::unique_ptr<Streamer> scene(new Streamer(radius));
+        frames = scene->fill(radius);
+        sections = scene->sections;
+        chunks = scene->manager.readyCount();
+    });
+    state.throughput("chunks", chunks);
+    state.counter("frames", frames);
+    state.counter("sections_ready", sections);
+}
+
+// fills a world, then moves the camera far away and times how long the
+// chunks in view near the camera take to become ready against the whole
+// load radius, which is what the view weighted priority is for
+BENCHMARK(streaming_teleport) {
+    const int radius = 8, view_radius = 3;
+    std::unique_ptr<Streamer> scene(new Streamer(radius));
+    scene->fill(radius);
+
+    scene->x = 4096.0f;
+    scene->z = -4096.0f;
+    scene->dir_x = 1.0f;
+    scene->dir_z = 0.0f;
+    const uint64_t start = monotonicNs();
+    size_t frames = 0, view_frames = 0;
+    double view_ms = 0.0;
+    // the first frame unloads the old chunks, so readyCount() starts over
+    do {
+        scene->frame();
+        frames++;
+        if (view_frames == 0 && scene->viewReady(view_radius)) {
+            view_frames = frames;
+            view_ms = (monotonicNs() - start) * 1e-6;
+        }
+        std::this_thread::yield();
+    } while (scene->manager.readyCount() < scene->inRange(radius));
+    const double all_ms = (monotonicNs() - start) * 1e-6;
+
+    state.counter("frames_to_view_ready", view_frames);
+    state.counter("frames_to_all_ready", frames);
+    state.counter("ms_to_view_ready", view_ms);
+    state.counter("ms_to_all_ready", all_ms);
+    // lighting is budgeted to LIGHT_BUDGET_NS a frame, this is how well
+    // that holds
+    state.counter("max_frame_ms", scene->max_frame_ns * 1e-6);
+}
+
+// the per frame cost once everything in range is loaded and the camera
+// stays inside its chunk
+BENCHMARK(streaming_update_steady) {
+    const int radius = 8;
+    std::unique_ptr<Streamer> scene(new Streamer(radius));
+    scene->fill(radius);
+
+    size_t frame = 0;
+    state.run([&] {
+        // wander inside the chunk and look around without crossing the
+        // reprioritize threshold every frame
+        scene->x = 8.0f + float(frame % 8);
+        scene->dir_x = std::sin(frame * 0.01f);
+        scene->dir_z = std::cos(frame * 0.01f);
+        scene->frame();
+        frame++;
+    });
+    state.throughput("frames", 1);
+    state.counter("chunks_loaded", scene->manager.loaded());
+}
@@ -0,0 +1,157 @@
+#include "./bench.hpp"
+#include "../include/noise.hpp"
+#include "../include/terrain.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+// the coordinates of every block of a section, as the generator feeds them
+struct SectionPoints {
+    float x[SECTION_VOLUME], y[SECTION_VOLUME], z[SECTION_VOLUME];
+
+    SectionPoints() {
+        for (int i = 0; i < SECTION_VOLUME; i++) {
+            this->x[i] = float(100 + (i & 15));
+            this->z[i] = float(-40 + ((i >> 4) & 15));
+            this->y[i] = float(32 + (i >> 8));
+        }
+    }
+};
+
+static void benchNoise(bench::State &state, Noise::Path path, int dimensions) {
+    if (Noise::setPath(path) != path) {
+        state.counter("unsupported", 1);
+        return;
+    }
+
+    std::unique_ptr<SectionPoints> points(new SectionPoints);
+    std::vector<float> out(SECTION_VOLUME);
+    state.run([&] {
+        if (dimensions == 2)
+            Noise::add2(points->x, points->z, SECTION_VOLUME, 1, 1.0f / 32.0f, 1.0f, out.data());
+        else
+            Noise::add3(points->x, points->y, points->z, SECTION_VOLUME, 1, 1.0f / 32.0f, 1.0f, out.data());
+        bench::doNotOptimize(out.data());
+    });
+    state.throughput("points", SECTION_VOLUME);
+    Noise::setPath(Noise::best());
+}
+
+BENCHMARK(noise2_scalar) { benchNoise(state, Noise::SCALAR, 2); }
+BENCHMARK(noise2_sse2)   { benchNoise(state, Noise::SSE2, 2); }
+BENCHMARK(noise2_avx2)   { benchNoise(state, Noise::AVX2, 2); }
+BENCHMARK(noise3_scalar) { benchNoise(state, Noise::SCALAR, 3); }
+BENCHMARK(noise3_sse2)   { benchNoise(state, Noise::SSE2, 3); }
+BENCHMARK(noise3_avx2)   { benchNoise(state, Noise::AVX2, 3); }
+
+// one chunk column on one thread, walking along x so no two are alike
+static void benchGenerate(bench::State &state, Noise::Path path,
+                          TerrainGenerator::Sampling sampling = TerrainGenerator::COARSE) {
+    if (Noise::setPath(path) != path) {
+        state.counter("unsupported", 1);
+        return;
+    }
+
+    const TerrainGenerator terrain(1337, sampling);
+    std::unique_ptr<Chunk> chunk(new Chunk(0, 0));
+    state.run([&] {
+        chunk->x++;
+        terrain.generate(*chunk);
+        bench::doNotOptimize(chunk->sections[0].paletteSize());
+    });
+    state.throughput("chunks", 1);
+    Noise::setPath(Noise::best());
+}
+
+BENCHMARK(terrain_generate_chunk_scalar) { benchGenerate(state, Noise::SCALAR); }
+BENCHMARK(terrain_generate_chunk_sse2)   { benchGenerate(state, Noise::SSE2); }
+BENCHMARK(terrain_generate_chunk_avx2)   { benchGenerate(state, Noise::AVX2); }
+// caves evaluated at every block instead of on the coarse lattice
+BENCHMARK(terrain_generate_chunk_full)   { benchGenerate(state, Noise::best(), TerrainGenerator::FULL); }
+
+// how far the interpolated cave fields stray from the real ones, and how
+// many blocks end up different because of it
+BENCHMARK(terrain_coarse_error) {
+    const TerrainGenerator full(1337, TerrainGenerator::FULL), coarse(1337, TerrainGenerator::COARSE);
+    const int radius = 2;
+
+    std::vector<float> full_a(SECTION_VOLUME), full_b(SECTION_VOLUME);
+    std::vector<float> coarse_a(SECTION_VOLUME), coarse_b(SECTION_VOLUME);
+    double total_error = 0.0, max_error = 0.0;
+    size_t samples = 0, solid = 0, mismatched = 0;
+    for (int x = -radius; x < radius; x++) {
+        for (int z = -radius; z < radius; z++) {
+            for (int sy = 0; sy < 5; sy++) {
+                full.caveFields(x, sy, z, full_a.data(), full_b.data());
+                coarse.caveFields(x, sy, z, coarse_a.data(), coarse_b.data());
+                for (int i = 0; i < SECTION_VOLUME; i++) {
+                    const double error = std::max(std::abs(full_a[i] - coarse_a[i]),
+                                                  std::abs(full_b[i] - coarse_b[i]));
+                    total_error += error;
+                    max_error = std::max(max_error, error);
+                    samples++;
+                }
+            }
+
+            std::unique_ptr<Chunk> a(new Chunk(x, z)), b(new Chunk(x, z));
+            full.generate(*a);
+            coarse.generate(*b);
+            for (int sy = 0; sy < CHUNK_SECTIONS; sy++) {
+                for (int i = 0; i < SECTION_VOLUME; i++) {
+                    const Block::BlockID id = a->sections[sy].get(i);
+                    solid += id != Block::AIR && id != Block::WATER;
+                    mismatched += id != b->sections[sy].get(i);
+                }
+            }
+        }
+    }
+
+    state.counter("mean_field_error", total_error / samples);
+    state.counter("max_field_error", max_error);
+    state.counter("mismatched_block_percent", 100.0 * mismatched / solid);
+}
+
+// generates the same chunks on every supported path and counts blocks that
+// differ from the scalar result, which must stay 0
+BENCHMARK(terrain_paths_identical) {
+    const TerrainGenerator terrain(1337);
+    const int radius = 2;
+    const size_t blocks = 4 * radius * radius * CHUNK_SECTIONS * SECTION_VOLUME;
+
+    std::vector<Block::BlockID> reference(blocks), other(blocks);
+    auto generateAll = [&](std::vector<Block::BlockID> &out) {
+        Block::BlockID *next = out.data();
+        for (int x = -radius; x < radius; x++) {
+            for (int z = -radius; z < radius; z++) {
+                std::unique_ptr<Chunk> chunk(new Chunk(x, z));
+                terrain.generate(*chunk);
+                for (const ChunkSection &section : chunk->sections) {
+                    section.unpack(next);
+                    next += SECTION_VOLUME;
+                }
+            }
+        }
+    };
+
+    Noise::setPath(Noise::SCALAR);
+    generateAll(reference);
+    for (int path = Noise::SSE2; path < Noise::PATH_COUNT; path++) {
+        if (Noise::setPath(Noise::Path(path)) != path)
+            continue;
+        generateAll(other);
+        size_t mismatched = 0;
+        for (size_t i = 0; i < blocks; i++)
+            mismatched += reference[i] != other[i];
+        state.counter(std::string("mismatched_blocks_") + Noise::name(Noise::Path(path)), mismatched);
+    }
+    Noise::setPath(Noise::best());
+
+    size_t air = 0;
+    for (Block::BlockID id : reference)
+        air += id == Block::AIR;
+    state.counter("air_percent", 100.0 * air / blocks);
+}
@@ -0,0 +1,40 @@
+#include "./bench.hpp"
+#include "../include/fixed_timestep.hpp"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+// frame times jittering around 60 fps with an occasional 500 ms hitch
+static std::vector<uint64_t> frameTimes(size_t n) {
+    std::mt19937 rng(4);
+    std::normal_distribution<double> jitter(16.6e6, 2e6);
+    std::vector<uint64_t> times(n);
+    uint64_t now = 0;
+    for (size_t i = 0; i < n; i++) {
+        now += i % 600 == 599 ? 500000000 : (uint64_t)std::max(1e6, jitter(rng));
+        times[i] = now;
+    }
+    return times;
+}
+
+BENCHMARK(fixed_timestep_advance) {
+    const std::vector<uint64_t> times = frameTimes(4096);
+    FixedTimestep timestep(20, 5);
+
+    uint64_t ticks = 0, frames = 0, hitches = 0, offset = 0;
+    state.run([&] {
+        // keep time moving forward as the frame list repeats
+        if (frames % times.size() == 0 && frames != 0)
+            offset += times.back();
+        ticks += timestep.advance(offset + times[frames % times.size()]);
+        hitches += frames % times.size() % 600 == 599;
+        frames++;
+        bench::doNotOptimize(timestep.alpha());
+    });
+
+    state.counter("ticks_per_frame", double(ticks) / frames);
+    // at 20 tps a 500 ms hitch owes 10 ticks and the clamp runs 5, so this
+    // should read 250
+    state.counter("dropped_ms_per_hitch", hitches ? timestep.droppedNs() / 1e6 / hitches : 0.0);
+}
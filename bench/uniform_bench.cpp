@@ -0,0 +1,49 @@
+#include "./bench.hpp"
+#include "../include/uniform_table.hpp"
+
+#include <string>
+#include <unordered_map>
+
+// the names a typical program would look up every draw
+static const char *const names[] = {
+    "model", "view", "projection", "blocks", "light_dir", "fog_color", "fog_start", "time"
+};
+static const int name_count = sizeof(names) / sizeof(names[0]);
+static const int updates = 10000;
+
+// synthetic: not the replaced path, which called glGetUniformLocation and
+// needs a GL context. a string-keyed search per call stands in for the
+// driver lookup, from a std::string built for the call as the old set
+// functions did. the real lookup is at least this expensive, and the GL
+// call itself isn't measured in either case.
+BENCHMARK(uniform_10k_updates_synthetic_string_lookup) {
+    std::unordered_map<std::string, int> locations;
+    for (int i = 0; i < name_count; i++)
+        locations[names[i]] = i;
+
+    int sum = 0;
+    state.run([&] {
+        for (int i = 0; i < updates; i++) {
+            const std::string name = names[i % name_count];
+            auto it = locations.find(name);
+            sum += it == locations.end() ? -1 : it->second;
+        }
+        bench::doNotOptimize(&sum);
+    });
+}
+
+// the reflected table Shader now keeps
+BENCHMARK(uniform_10k_updates_table_lookup) {
+    UniformTable locations;
+    for (int i = 0; i < name_count; i++)
+        locations.insert(names[i], i);
+
+    int sum = 0;
+    state.run([&] {
+        for (int i = 0; i < updates; i++) {
+            const int location = locations.find(names[i % name_count]);
+            sum += location;
+        }
+        bench::doNotOptimize(&sum);
+    });
+}
@@ -0,0 +1,62 @@
+#include "./bench.hpp"
+#include "./scenes.hpp"
+#include "../include/visibility.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+static void randomScene(ChunkSection &section) {
+    fillRandom(section, 7, 0.3f);
+}
+
+static void benchConnections(bench::State &state, void (*scene)(ChunkSection &)) {
+    ChunkSection section;
+    scene(section);
+
+    FaceConnections faces = 0;
+    state.run([&] {
+        faces = sectionConnections(section);
+        bench::doNotOptimize(&faces);
+    });
+    int pairs = 0;
+    for (int a = 0; a < Block::FACE_COUNT; a++)
+        for (int b = a + 1; b < Block::FACE_COUNT; b++)
+            pairs += facesConnected(faces, a, b);
+    state.counter("connected_pairs", pairs);
+}
+
+BENCHMARK(section_connections_terrain) { benchConnections(state, fillTerrain); }
+BENCHMARK(section_connections_random)  { benchConnections(state, randomScene); }
+
+// the frustum pass then the graph search, as Window::render() runs them
+static void benchOcclusion(bench::State &state, float x, float y, float z, float yaw, float pitch) {
+    static std::unique_ptr<CaveWorld> scene(new CaveWorld(12));
+
+    float clip[16];
+    cameraMatrix(x, y, z, yaw, pitch, clip);
+    const Frustum frustum(clip);
+    const SectionPos start = { int32_t(std::floor(x / SECTION_SIZE)), int32_t(std::floor(y / SECTION_SIZE)),
+                               int32_t(std::floor(z / SECTION_SIZE)) };
+
+    std::vector<SectionPos> visible;
+    size_t in_frustum = 0, reached = 0;
+    state.run([&] {
+        visible.clear();
+        in_frustum = scene->bounds.cull(frustum, visible);
+        reached = scene->graph.traverse(start, frustum);
+        visible.erase(std::remove_if(visible.begin(), visible.end(),
+            [&](const SectionPos &pos) { return !scene->graph.reached(pos); }), visible.end());
+    });
+    state.counter("meshed_sections", scene->bounds.size());
+    state.counter("in_frustum", in_frustum);
+    state.counter("reached", reached);
+    state.counter("drawn", visible.size());
+    state.counter("occluded_percent", in_frustum ? 100.0 * (in_frustum - visible.size()) / in_frustum : 0.0);
+}
+
+// standing on a hill looking out over the terrain
+BENCHMARK(occlusion_surface) { benchOcclusion(state, 0.5f, 75.0f, 0.5f, 20.0f, -10.0f); }
+// deep underground, inside the stone between the caves
+BENCHMARK(occlusion_underground) { benchOcclusion(state, 0.5f, 30.0f, 0.5f, 20.0f, -10.0f); }
@@ -0,0 +1,50 @@
+#ifndef ARENA_ALLOCATOR_H
+#define ARENA_ALLOCATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+
+// hands out ranges of a fixed-size arena, in whatever unit the caller
+// counts in. free ranges are kept both by offset, so a freed range merges
+// with its neighbours, and by size, so allocation takes the smallest range
+// that fits. only does the bookkeeping, the memory lives elsewhere (a GPU
+// buffer for ChunkArena).
+class ArenaAllocator {
+public:
+
+    // returned by allocate() when no free range is big enough
+    static const size_t NONE = SIZE_MAX;
+
+    ArenaAllocator(size_t capacity = 0);
+
+    // offset of a new range of size units, or NONE
+    size_t allocate(size_t size);
+    // returns a range from allocate(), size must match
+    void free(size_t offset, size_t size);
+
+    // enlarges the arena, the new space is free
+    void grow(size_t capacity);
+
+    size_t capacity() const;
+    size_t used() const;
+    size_t largestFree() const;
+    size_t freeRanges() const;
+
+    // 0 while the free space is one contiguous range, approaching 1 as it
+    // splinters into pieces too small for a large allocation
+    float fragmentation() const;
+
+private:
+
+    size_t total, in_use;
+    // offset -> size, and size -> offset, of every free range
+    std::map<size_t, size_t> by_offset;
+    std::multimap<size_t, size_t> by_size;
+
+    void addRange(size_t offset, size_t size);
+    void removeRange(std::map<size_t, size_t>::iterator it);
+
+};
+
+#endif
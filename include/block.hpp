@@ -1,21 +1,99 @@
 #ifndef BLOCK_H
 #define BLOCK_H
 
-#include <glm/glm.hpp>
+#include <cstdint>
 
+// every block type, one entry each. adding a block is adding a line here, the
+// id enum and every property column below are generated from this table.
+//
+//   opacity  - how much light the block absorbs, 15 is fully opaque
+//   solid    - whether entities collide with it
+//   emission - block light level it gives off, 0 to 15
+//   top, side, bottom - atlas tiles, numbered row by row from the top left
+//                       of img/blocks.png
+//
+// X(name,         opacity, solid, emission, top, side, bottom)
+#define BLOCK_TABLE(X) \
+    X(AIR,         0,       false, 0,        0,   0,    0) \
+    X(GRASS,       15,      true,  0,        0,   1,    2) \
+    X(DIRT,        15,      true,  0,        2,   2,    2) \
+    X(STONE,       15,      true,  0,        3,   3,    3) \
+    X(SAND,        15,      true,  0,        16,  16,   16) \
+    X(WATER,       2,       false, 0,        32,  32,   32) \
+    X(COBBLESTONE, 15,      true,  0,        4,   4,    4) \
+    X(GRAVEL,      15,      true,  0,        5,   5,    5) \
+    X(GLASS,       0,       true,  0,        17,  17,   17) \
+    X(LOG,         15,      true,  0,        22,  18,   22) \
+    X(PLANKS,      15,      true,  0,        19,  19,   19) \
+    X(LEAVES,      1,       true,  0,        20,  20,   20) \
+    X(BRICK,       15,      true,  0,        21,  21,   21) \
+    X(LAVA,        15,      false, 15,       64,  64,   64)
+
+#define BLOCK_ID(name, opacity, solid, emission, top, side, bottom) name,
+#define BLOCK_OPACITY(name, opacity, solid, emission, top, side, bottom) opacity,
+#define BLOCK_SOLID(name, opacity, solid, emission, top, side, bottom) solid,
+#define BLOCK_EMISSION(name, opacity, solid, emission, top, side, bottom) emission,
+#define BLOCK_TOP(name, opacity, solid, emission, top, side, bottom) top,
+#define BLOCK_SIDE(name, opacity, solid, emission, top, side, bottom) side,
+#define BLOCK_BOTTOM(name, opacity, solid, emission, top, side, bottom) bottom,
+#define BLOCK_OPAQUE_BIT(name, opacity, solid, emission, top, side, bottom) \
+    | ((opacity) == 15 ? uint64_t(1) << name : 0)
+
+// compile-time block registry. properties are stored as one constexpr column
+// per property indexed by BlockID, so hot loops only touch the column they
+// need instead of a whole object per block.
 class Block {
 public:
 
     enum BlockID {
-        AIR     = 0,
-        GRASS   = 1
+        BLOCK_TABLE(BLOCK_ID)
+        BLOCK_COUNT
+    };
+
+    // faces of a block, in +x -x +y -y +z -z order
+    enum Face {
+        POS_X, NEG_X, POS_Y, NEG_Y, POS_Z, NEG_Z,
+        FACE_COUNT
+    };
+
+    static constexpr uint8_t opacity[BLOCK_COUNT] = { BLOCK_TABLE(BLOCK_OPACITY) };
+    static constexpr bool solid[BLOCK_COUNT] = { BLOCK_TABLE(BLOCK_SOLID) };
+    static constexpr uint8_t emission[BLOCK_COUNT] = { BLOCK_TABLE(BLOCK_EMISSION) };
+
+    // atlas tile per face, tile[face][id]
+    static constexpr uint8_t tile[FACE_COUNT][BLOCK_COUNT] = {
+        { BLOCK_TABLE(BLOCK_SIDE) },
+        { BLOCK_TABLE(BLOCK_SIDE) },
+        { BLOCK_TABLE(BLOCK_TOP) },
+        { BLOCK_TABLE(BLOCK_BOTTOM) },
+        { BLOCK_TABLE(BLOCK_SIDE) },
+        { BLOCK_TABLE(BLOCK_SIDE) }
     };
 
-    bool transparent;
-    glm::vec2 texure_location;
+    // bit id is set if the block is fully opaque
+    static constexpr uint64_t opaque_mask = 0 BLOCK_TABLE(BLOCK_OPAQUE_BIT);
+
+    static constexpr bool isOpaque(BlockID id) {
+        return (opaque_mask >> id) & 1;
+    }
 
-    void block_init();
+    // a face is drawn unless the neighbour covering it is opaque, or is the
+    // same see-through block (no walls between two water blocks)
+    static constexpr bool isFaceVisible(BlockID block, BlockID neighbour) {
+        return block != AIR && !isOpaque(neighbour) && block != neighbour;
+    }
 
 };
 
+static_assert(Block::BLOCK_COUNT <= 64, "Block::opaque_mask holds one bit per block id");
+
+#undef BLOCK_ID
+#undef BLOCK_OPACITY
+#undef BLOCK_SOLID
+#undef BLOCK_EMISSION
+#undef BLOCK_TOP
+#undef BLOCK_SIDE
+#undef BLOCK_BOTTOM
+#undef BLOCK_OPAQUE_BIT
+
 #endif
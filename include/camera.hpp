@@ -0,0 +1,26 @@
+#ifndef CAMERA_H
+#define CAMERA_H
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+class Camera {
+public:
+
+    glm::vec3 position, front, up;
+    // degrees, yaw of -90 looks down -z
+    float yaw, pitch, fov;
+
+    Camera(glm::vec3 position = glm::vec3(0.0f, 0.0f, 3.0f));
+
+    glm::mat4 view() const;
+    glm::mat4 projection(float aspect) const;
+
+    // turns the camera by a mouse movement in screen pixels
+    void look(float xoffset, float yoffset);
+    // narrows or widens the field of view by scroll wheel steps
+    void zoom(float yoffset);
+
+};
+
+#endif
@@ -0,0 +1,138 @@
+#ifndef CHUNK_H
+#define CHUNK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "./block.hpp"
+#include "./config.hpp"
+
+// a 16x16x16 cube of blocks. instead of one Block per voxel the section keeps
+// a palette of the distinct BlockIDs it contains and a packed array of
+// palette indices, each index using only as many bits as the palette needs.
+// a section made of a single block type (all air, all stone) stores no index
+// array at all.
+class ChunkSection {
+public:
+
+    ChunkSection(Block::BlockID fill = Block::AIR);
+
+    // index of a block inside the section, x varies fastest then z then y
+    static inline int index(int x, int y, int z) {
+        return (y << 8) | (z << 4) | x;
+    }
+
+    Block::BlockID get(int x, int y, int z) const;
+    Block::BlockID get(int index) const;
+
+    void set(int x, int y, int z, Block::BlockID id);
+    void set(int index, Block::BlockID id);
+
+    // replaces every block in the section with id
+    void fill(Block::BlockID id);
+
+    // replaces every block in the section from a SECTION_VOLUME array laid
+    // out in index() order, building the palette in a single pass
+    void assign(const Block::BlockID *blocks);
+
+    // decodes every block into a SECTION_VOLUME array in index() order
+    void unpack(Block::BlockID *out) const;
+
+    // true if the whole section is a single block type
+    bool isUniform() const;
+    // true if the whole section is air
+    bool isEmpty() const;
+
+    // number of distinct block types currently in the section
+    int paletteSize() const;
+    // width of one packed palette index, 0 for uniform sections
+    int bitsPerBlock() const;
+    // heap and inline bytes held by this section
+    size_t memoryUsage() const;
+
+private:
+
+    // palette slot -> block id, slots with a zero refcount are free
+    std::vector<Block::BlockID> palette;
+    // palette slot -> number of blocks using it
+    std::vector<uint16_t> refcount;
+    // packed palette indices, never split across words
+    std::vector<uint64_t> words;
+    // bits per packed index, one of 0, 1, 2, 4, 8, 16
+    uint8_t bits;
+    // number of palette slots with a non-zero refcount
+    uint16_t live;
+
+    int readSlot(int index) const;
+    void writeSlot(int index, int slot);
+
+    int findSlot(Block::BlockID id) const;
+    int addSlot(Block::BlockID id);
+    void releaseSlot(int slot);
+
+    // re-encodes the index array at a new width, dropping free slots
+    void repack(uint8_t new_bits);
+
+};
+
+// one 4 bit value per block of a section, two to a byte. like a uniform
+// ChunkSection, an array holding the same value everywhere (open sky, solid
+// rock) keeps no storage until a different value is written.
+class NibbleArray {
+public:
+
+    NibbleArray(uint8_t fill = 0);
+
+    // index is ChunkSection::index()
+    inline uint8_t get(int index) const {
+        if (this->nibbles.empty())
+            return this->uniform;
+        return (this->nibbles[index >> 1] >> ((index & 1) << 2)) & 15;
+    }
+
+    void set(int index, uint8_t value);
+    // sets every value, releasing the storage
+    void fill(uint8_t value);
+    // releases the storage if every value turned out the same
+    void compact();
+
+    bool isUniform() const;
+    size_t memoryUsage() const;
+
+private:
+
+    std::vector<uint8_t> nibbles;
+    // the value everywhere while nibbles is empty
+    uint8_t uniform;
+
+};
+
+// light levels of a section's blocks, 0 to 15. sky light is light from
+// above the world, block light comes from emitting blocks.
+struct LightSection {
+    NibbleArray sky;
+    NibbleArray block;
+
+    size_t memoryUsage() const;
+};
+
+// a full-height column of sections at chunk coordinates (x, z)
+class Chunk {
+public:
+
+    int32_t x, z;
+    ChunkSection sections[CHUNK_SECTIONS];
+    // filled in by LightEngine, dark until then
+    LightSection light[CHUNK_SECTIONS];
+
+    Chunk(int32_t x, int32_t z);
+
+    // chunk-local coordinates, y in [0, CHUNK_HEIGHT)
+    Block::BlockID get(int x, int y, int z) const;
+    void set(int x, int y, int z, Block::BlockID id);
+
+    size_t memoryUsage() const;
+
+};
+
+#endif
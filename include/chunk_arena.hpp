@@ -0,0 +1,74 @@
+#ifndef CHUNK_ARENA_H
+#define CHUNK_ARENA_H
+
+#include <glad/glad.h>
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+#include "./arena_allocator.hpp"
+#include "./config.hpp"
+#include "./mesher.hpp"
+#include "./world.hpp"
+
+// where one section's mesh lives inside the arena
+struct ArenaSlot {
+    // in blocks of ARENA_BLOCK_VERTICES vertices
+    size_t vertex_block, vertex_blocks;
+    // in indices
+    size_t index_offset, index_count;
+};
+
+// every section's mesh, sub-allocated from one shared vertex buffer and one
+// shared index buffer behind a single VAO, so any set of sections draws with
+// one glMultiDrawElementsBaseVertex call and no rebinding.
+//
+// vertices are section-local, so the shader finds each section's origin in
+// a buffer texture holding one origin per ARENA_BLOCK_VERTICES vertices.
+// gl_VertexID includes the base vertex, which makes it a direct index.
+class ChunkArena {
+public:
+
+    ChunkArena();
+
+    // allocates the GL buffers, sizes are in vertices and indices and grow
+    // on demand. needs a current GL context.
+    void create(size_t vertex_capacity, size_t index_capacity);
+
+    // replaces the section's mesh, an empty mesh removes it
+    void upload(SectionPos pos, const ChunkMesh &mesh);
+    void remove(SectionPos pos);
+
+    // draws the listed sections, skipping any without a mesh. returns the
+    // number of draw calls issued.
+    size_t draw(const std::vector<SectionPos> &sections);
+
+    // binds the origin lookup for the shader's isamplerBuffer
+    void bindOrigins(unsigned int unit) const;
+
+    size_t sectionCount() const;
+    const ArenaAllocator &vertexSpace() const;
+    const ArenaAllocator &indexSpace() const;
+
+    void destroy();
+
+private:
+
+    unsigned int VAO, VBO, EBO;
+    // one ivec4 origin per vertex block, read through origin_texture
+    unsigned int origin_buffer, origin_texture;
+
+    ArenaAllocator vertex_space, index_space;
+    std::unordered_map<SectionPos, ArenaSlot, SectionPosHash> slots;
+
+    // scratch arrays for glMultiDrawElementsBaseVertex
+    std::vector<GLsizei> counts;
+    std::vector<const void *> offsets;
+    std::vector<GLint> base_vertices;
+
+    void growVertices(size_t blocks);
+    void growIndices(size_t indices);
+    void bindVertexLayout();
+
+};
+
+#endif
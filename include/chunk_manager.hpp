@@ -0,0 +1,137 @@
+#ifndef CHUNK_MANAGER_H
+#define CHUNK_MANAGER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "./config.hpp"
+#include "./job_system.hpp"
+#include "./light_engine.hpp"
+#include "./mpsc_queue.hpp"
+#include "./terrain.hpp"
+#include "./world.hpp"
+
+// streams chunks in around the camera and out again behind it. a chunk is
+// generated on the job system, lit in batches once its neighbours have
+// blocks, and its sections are handed out for meshing once it and its
+// neighbours are lit, since a mesh reads blocks and light one block across.
+//
+// every stage takes the waiting chunk nearest the camera first, weighted
+// towards the view direction, so after a teleport the chunks in front of
+// the camera fill in before the ones behind it. work for chunks that fall
+// out of range is dropped, and loaded chunks stay until UNLOAD_HYSTERESIS
+// chunks further out, so a camera pacing along the edge doesn't reload them.
+class ChunkManager {
+public:
+
+    ChunkManager(World &world, LightEngine &light, const TerrainGenerator &terrain, JobSystem &jobs,
+                 int radius = LOAD_RADIUS);
+
+    // moves the camera, in block coordinates, facing along (dir_x, dir_z),
+    // and runs a frame of streaming: finished chunks join the world, new
+    // ones are queued and generation started, and chunks are lit for up to
+    // LIGHT_BUDGET_NS. chunks removed from the world are appended to
+    // unloaded, their sections' meshes are for the caller to drop.
+    void update(float x, float y, float z, float dir_x, float dir_z, std::vector<ChunkPos> &unloaded);
+
+    // takes the world's dirty sections and returns the ones ready to mesh,
+    // most urgent first. the rest are dropped, every section of a chunk is
+    // marked dirty again when it becomes ready
+    std::vector<SectionPos> takeDirty();
+
+    // lower goes first: distance from the camera in chunks, stretched up to
+    // three times for chunks behind it
+    float priority(int32_t x, int32_t z) const;
+
+    // whether the chunk's sections can be meshed
+    bool ready(int32_t x, int32_t z) const;
+
+    // chunks tracked in each stage
+    size_t queued() const;
+    size_t generating() const;
+    size_t loaded() const;
+    size_t readyCount() const;
+
+private:
+
+    enum Stage { QUEUED, GENERATING, GENERATED, LIT };
+
+    struct Entry {
+        int32_t x, z;
+        Stage stage;
+        bool ready;
+        // of the generation job last started, so a result arriving after
+        // the chunk was dropped and queued again is recognised as stale
+        uint32_t version;
+    };
+
+    struct Generated {
+        std::unique_ptr<Chunk> chunk;
+        uint32_t version;
+    };
+
+    // a queued chunk and its priority when it was pushed
+    struct Candidate {
+        float priority;
+        int32_t x, z;
+
+        bool operator<(const Candidate &other) const {
+            return this->priority > other.priority;
+        }
+    };
+
+    World &world;
+    LightEngine &light;
+    const TerrainGenerator terrain;
+    JobSystem &jobs;
+    int radius;
+
+    std::unordered_map<uint64_t, Entry> entries;
+    // QUEUED chunks as a heap, best first. entries are skipped when popped
+    // if the chunk moved on or was dropped
+    std::vector<Candidate> heap;
+    // GENERATED chunks, and LIT chunks not yet ready
+    std::unordered_set<uint64_t> unlit, unready;
+    // shared with the jobs, like MeshScheduler's results
+    std::shared_ptr<MpscQueue<Generated>> finished;
+    // generation jobs running, including ones for dropped chunks
+    size_t in_flight;
+    size_t generating_count, lit_count, ready_count;
+    uint32_t next_version;
+    // wall time per chunk of the lighting batches so far, 0 before the
+    // first. sizes the next batch to what is left of the budget
+    double light_ns_per_chunk;
+
+    float x, y, z, dir_x, dir_z;
+    // the chunk the camera was in and the direction it faced when the
+    // ranges were last scanned and the heap last ordered
+    int32_t camera_x, camera_z;
+    float sorted_dir_x, sorted_dir_z;
+    bool scanned;
+
+    const Entry *find(int32_t x, int32_t z) const;
+    bool inRange(int32_t x, int32_t z, int range) const;
+
+    // queues chunks that came into range and drops or unloads the ones
+    // that left it
+    void scan(std::vector<ChunkPos> &unloaded);
+    void reprioritize();
+    void receive();
+    void startGeneration();
+    // lights the most urgent chunks whose neighbours have their blocks, in
+    // batches, for up to LIGHT_BUDGET_NS. then marks ready every lit chunk
+    // whose neighbours are lit too.
+    //
+    // lighting is synchronous: this thread joins the workers on each batch
+    // and waits for it, since the world can't gain or lose chunks while a
+    // batch runs. batches are cut to the chunks the time per chunk so far
+    // says fit in the rest of the budget, so a frame overshoots it by at
+    // most a misjudged batch, or by the one chunk lit every frame
+    void lightBatches();
+
+};
+
+#endif
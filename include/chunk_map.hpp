@@ -0,0 +1,198 @@
+#ifndef CHUNK_MAP_H
+#define CHUNK_MAP_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// a flat robin hood hash table from chunkKey()s to T. entries sit in one
+// array and probe linearly from the slot the key hashes to; an insert takes
+// over the slot of any entry nearer its own home than the new one is, so
+// probe lengths stay short and a lookup can stop as soon as it passes where
+// its key would have been. erasing shifts the entries after it back a slot
+// instead of leaving a tombstone.
+//
+// each thread remembers the last key it found and where, since lookups come
+// in runs for the same chunk (a block and its neighbours). several threads
+// may look up at once as long as none modifies the map.
+template <typename T>
+class ChunkMap {
+public:
+
+    ChunkMap() {
+        this->slots.resize(size_t(1) << MIN_BITS);
+        this->shift = 64 - MIN_BITS;
+        this->count = 0;
+        this->generation = nextGeneration();
+    }
+
+    ChunkMap(const ChunkMap &) = delete;
+    ChunkMap &operator=(const ChunkMap &) = delete;
+
+    // value stored under key, nullptr if there is none
+    const T *find(uint64_t key) const {
+        LastHit &last = lastHit();
+        if (last.generation == this->generation && last.key == key)
+            return last.value;
+
+        const Slot *slot = this->findSlot(key);
+        if (!slot)
+            return nullptr;
+        last = { this->generation, key, &slot->value };
+        return &slot->value;
+    }
+
+    T *find(uint64_t key) {
+        return const_cast<T *>(static_cast<const ChunkMap &>(*this).find(key));
+    }
+
+    // stores value under key, replacing any value already there
+    T &insert(uint64_t key, T value) {
+        Slot *existing = const_cast<Slot *>(this->findSlot(key));
+        if (existing) {
+            existing->value = std::move(value);
+            return existing->value;
+        }
+
+        // at most 4/5 full
+        if ((this->count + 1) * 5 > this->slots.size() * 4)
+            this->grow();
+        this->count++;
+        // entries are about to move, so every thread's last hit is stale
+        this->generation = nextGeneration();
+
+        Slot incoming;
+        incoming.key = key;
+        incoming.value = std::move(value);
+        return *this->place(std::move(incoming));
+    }
+
+    // false if there was nothing under key
+    bool erase(uint64_t key) {
+        const Slot *found = this->findSlot(key);
+        if (!found)
+            return false;
+        this->count--;
+        this->generation = nextGeneration();
+
+        // pull every displaced entry after it one slot nearer its home
+        size_t index = size_t(found - this->slots.data());
+        const size_t mask = this->slots.size() - 1;
+        for (;;) {
+            Slot &next = this->slots[(index + 1) & mask];
+            if (next.distance <= 1)
+                break;
+            this->slots[index] = std::move(next);
+            this->slots[index].distance--;
+            index = (index + 1) & mask;
+        }
+        this->slots[index] = Slot();
+        return true;
+    }
+
+    void clear() {
+        for (Slot &slot : this->slots)
+            slot = Slot();
+        this->count = 0;
+        this->generation = nextGeneration();
+    }
+
+    size_t size() const {
+        return this->count;
+    }
+
+    size_t capacity() const {
+        return this->slots.size();
+    }
+
+private:
+
+    static const int MIN_BITS = 4;
+
+    struct Slot {
+        uint64_t key = 0;
+        // 1 + slots from the key's home, 0 for an empty slot
+        uint32_t distance = 0;
+        T value = T();
+    };
+
+    struct LastHit {
+        uint64_t generation, key;
+        const T *value;
+    };
+
+    std::vector<Slot> slots;
+    // 64 - log2 of the slot count
+    int shift;
+    size_t count;
+    // changes whenever entries move, unique across every map, so a last
+    // hit is only trusted by the map and layout that recorded it
+    uint64_t generation;
+
+    // never 0, so a thread's zeroed last hit matches nothing
+    static uint64_t nextGeneration() {
+        static std::atomic<uint64_t> next(0);
+        return next.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    static LastHit &lastHit() {
+        static thread_local LastHit last = { 0, 0, nullptr };
+        return last;
+    }
+
+    // fibonacci hashing, the top bits of the key times 2^64 / phi
+    size_t home(uint64_t key) const {
+        return size_t((key * 0x9E3779B97F4A7C15ull) >> this->shift);
+    }
+
+    const Slot *findSlot(uint64_t key) const {
+        const size_t mask = this->slots.size() - 1;
+        size_t index = this->home(key);
+        for (uint32_t distance = 1;; distance++) {
+            const Slot &slot = this->slots[index];
+            // the key would have taken this slot over if it were stored
+            // further on, and an empty slot ends every probe
+            if (slot.distance < distance)
+                return nullptr;
+            if (slot.key == key)
+                return &slot;
+            index = (index + 1) & mask;
+        }
+    }
+
+    // puts a key known to be absent in, returning where its value landed
+    T *place(Slot incoming) {
+        const size_t mask = this->slots.size() - 1;
+        size_t index = this->home(incoming.key);
+        incoming.distance = 1;
+        T *placed = nullptr;
+        for (;; index = (index + 1) & mask, incoming.distance++) {
+            Slot &slot = this->slots[index];
+            if (slot.distance == 0) {
+                slot = std::move(incoming);
+                return placed ? placed : &slot.value;
+            }
+            // take from the rich: the entry nearer its home moves on
+            if (slot.distance < incoming.distance) {
+                std::swap(slot, incoming);
+                if (!placed)
+                    placed = &slot.value;
+            }
+        }
+    }
+
+    void grow() {
+        std::vector<Slot> old(this->slots.size() * 2);
+        old.swap(this->slots);
+        this->shift--;
+        for (Slot &slot : old) {
+            if (slot.distance != 0)
+                this->place(std::move(slot));
+        }
+    }
+
+};
+
+#endif
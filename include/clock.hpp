@@ -0,0 +1,14 @@
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <chrono>
+#include <cstdint>
+
+// nanoseconds on a monotonic clock with an arbitrary epoch, only meaningful
+// as a difference between two calls
+static inline uint64_t monotonicNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#endif
@@ -1,2 +1,63 @@
+#ifndef CONFIG_H
+#define CONFIG_H
+
 #define SCR_WIDTH 1920
-#define SCR_HEIGHT 1080
\ No newline at end of file
+#define SCR_HEIGHT 1080
+
+// edge length of a cubic chunk section, in blocks
+#define SECTION_SIZE 16
+// number of blocks in a chunk section
+#define SECTION_VOLUME (SECTION_SIZE * SECTION_SIZE * SECTION_SIZE)
+// number of sections stacked in a chunk column
+#define CHUNK_SECTIONS 16
+// height of a chunk column, in blocks
+#define CHUNK_HEIGHT (SECTION_SIZE * CHUNK_SECTIONS)
+
+// seed the terrain generator builds the world from
+#define WORLD_SEED 1337
+
+// simulation rate, independent of the frame rate
+#define TICKS_PER_SECOND 20
+// most ticks run in one frame before the simulation gives up catching up
+#define MAX_TICKS_PER_FRAME 5
+
+// time the render thread may spend uploading finished meshes each frame
+#define UPLOAD_BUDGET_NS 2000000
+
+// chunks streamed in around the camera, as a radius in chunks
+#define LOAD_RADIUS 12
+// chunks past the load radius a chunk must be before it is unloaded
+#define UNLOAD_HYSTERESIS 2
+// time the main thread may spend lighting newly generated chunks each frame
+#define LIGHT_BUDGET_NS 4000000
+
+// distances, in chunks, beyond which sections mesh from 2x2x2 and then
+// 4x4x4 cells
+#define LOD1_DISTANCE 8
+#define LOD2_DISTANCE 16
+// chunks a section must be past a level boundary before it switches
+#define LOD_HYSTERESIS 1
+
+// chunk meshes share one vertex and one index buffer, these are their
+// starting sizes; both double when full
+#define ARENA_VERTICES (1 << 20)
+#define ARENA_INDICES (3 << 19)
+// vertices per entry of the arena's section origin lookup, the unit the
+// vertex buffer is allocated in
+#define ARENA_BLOCK_VERTICES 64
+
+// texture bytes the render thread may upload each frame
+#define TEXTURE_UPLOAD_BUDGET (256 * 1024)
+
+// linked shader programs are cached here between launches
+#define SHADER_CACHE_DIR "../shader_cache"
+
+// uniform buffer binding point of the per-frame Frame block
+#define FRAME_UNIFORM_BINDING 0
+
+// frames of profiler history kept for min/avg/p99
+#define PROFILER_HISTORY 240
+// frames recorded by a trace capture started with F2
+#define TRACE_FRAMES 300
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef FIXED_TIMESTEP_H
+#define FIXED_TIMESTEP_H
+
+#include <cstdint>
+
+// decides how many fixed-length simulation ticks are due each frame. frame
+// time accumulates and is paid out in whole ticks; whatever is left over
+// becomes the interpolation alpha for rendering between the last two ticks.
+class FixedTimestep {
+public:
+
+    FixedTimestep(uint32_t tps, uint32_t max_ticks);
+
+    // restarts timing from now_ns, with no time owed
+    void reset(uint64_t now_ns);
+
+    // moves the clock to now_ns and returns the number of ticks to run. if
+    // more than max_ticks are owed the rest are dropped, so a slow frame
+    // can't snowball into ever longer catch-up frames.
+    uint32_t advance(uint64_t now_ns);
+
+    // fraction of a tick elapsed since the last tick, 0 to 1
+    float alpha() const;
+
+    // tps is clamped to 1 through 1000000000
+    void setRate(uint32_t tps);
+    uint32_t rate() const;
+    // length of one tick in nanoseconds
+    uint64_t tickNs() const;
+    // total time thrown away by the max_ticks clamp
+    uint64_t droppedNs() const;
+
+private:
+
+    uint32_t tps, max_ticks;
+    uint64_t tick_ns;
+    uint64_t last_ns;
+    // time owed to the simulation that doesn't yet make a whole tick
+    uint64_t remainder;
+    uint64_t dropped;
+
+};
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "./chunk_map.hpp"
+#include "./world.hpp"
+
+// the six clip planes of a camera, taken straight from its projection * view
+// matrix. planes point inwards, a point is inside when every plane gives
+// a*x + b*y + c*z + d >= 0.
+class Frustum {
+public:
+
+    enum Plane { LEFT, RIGHT, BOTTOM, TOP, NEAR, FAR, PLANE_COUNT };
+
+    float planes[PLANE_COUNT][4];
+
+    // a frustum containing everything
+    Frustum();
+    // clip is a column-major 4x4 matrix, as given by glm::value_ptr()
+    explicit Frustum(const float *clip);
+
+    // false only if the box is entirely outside one of the planes. boxes
+    // near a corner of the frustum can pass without being visible, which
+    // only costs a draw.
+    bool testBox(const float min[3], const float max[3]) const;
+
+    // tests count cubes of edge size whose min corners are given as three
+    // separate coordinate arrays, four cubes at a time. writes the index of
+    // every cube that passes to visible, which must hold count entries, and
+    // returns how many passed.
+    size_t cullCubes(const float *x, const float *y, const float *z, size_t count,
+                     float size, uint32_t *visible) const;
+
+    // for count columns of 64 cubes of edge size stacked from y = 0, with
+    // min corners at x and z, sets bit i of kept for every cube i that
+    // cullCubes() would keep. each plane keeps the cubes on one side of a
+    // height, so a column's cubes are tested together, four columns at a
+    // time, and the ones kept are always a single run.
+    void cullColumns(const float *x, const float *z, size_t count, float size,
+                     uint64_t *kept) const;
+
+};
+
+// the bounds of every section with a mesh, grouped by chunk column. each
+// column keeps a bit per meshed section, so culling goes through
+// Frustum::cullColumns() once per column rather than once per section.
+// columns are added and removed as meshes come and go, so the arrays stay
+// dense without being rebuilt every frame.
+class SectionBounds {
+public:
+
+    // does nothing if pos is already present
+    void insert(const SectionPos &pos);
+    // does nothing if pos isn't present
+    void erase(const SectionPos &pos);
+    void clear();
+    size_t size() const;
+
+    // appends every section at least partly inside frustum to visible and
+    // returns how many were appended
+    size_t cull(const Frustum &frustum, std::vector<SectionPos> &visible);
+
+private:
+
+    // per column: min corner in world block coordinates and which sections
+    // are meshed, bit y for section y
+    std::vector<float> x, z;
+    std::vector<uint64_t> sections;
+    std::vector<ChunkPos> columns;
+    // chunkKey() -> the column's index in the arrays above
+    ChunkMap<uint32_t> indices;
+    size_t count = 0;
+
+    // scratch for cull()
+    std::vector<uint64_t> kept;
+
+};
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// a fixed pool of worker threads running queued jobs in submission order
+class JobSystem {
+public:
+
+    // threads defaults to one less than the number of hardware threads, so
+    // the render thread keeps a core to itself
+    JobSystem(unsigned threads = 0);
+    // finishes the jobs already running, drops the ones still queued
+    ~JobSystem();
+
+    void submit(std::function<void()> job);
+
+    // jobs queued or running
+    size_t pending() const;
+    unsigned threadCount() const;
+
+private:
+
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> jobs;
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::atomic<size_t> unfinished;
+    bool stopping;
+
+    void work(unsigned index);
+
+};
+
+#endif
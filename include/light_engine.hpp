@@ -0,0 +1,147 @@
+#ifndef LIGHT_ENGINE_H
+#define LIGHT_ENGINE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+#include "./chunk.hpp"
+#include "./job_system.hpp"
+#include "./world.hpp"
+
+// flood fills sky and block light through a World, one breadth first queue
+// per channel. light drops by a block's opacity (at least 1) per step,
+// except sky light at full strength, which falls straight down through
+// clear blocks without dimming.
+//
+// an edit is relit with the usual two queue scheme: the light it may have
+// fed is darkened outwards until the search meets light from somewhere
+// else, then that light is spread back into the dark area. only blocks the
+// edit could have affected are touched.
+//
+// steps that cross into another chunk are collected and run together one
+// neighbouring chunk at a time, so the search stays inside a chunk as long
+// as it can instead of looking chunks up block by block.
+//
+// lighting a chunk reads and writes only the 3x3 chunks around it (light
+// fades before it can cross a whole chunk), so lightChunks() spreads a
+// batch over the job system with each job holding locks on its 3x3
+// neighbourhood. jobs in different neighbourhoods run in parallel.
+class LightEngine {
+public:
+
+    enum Channel { SKY, BLOCK, CHANNEL_COUNT };
+
+    explicit LightEngine(World &world);
+
+    // lights a chunk whose blocks were just filled in, and lets light from
+    // and into its loaded neighbours spread across the borders
+    void lightChunk(int32_t x, int32_t z);
+    // lightChunk() for every chunk of a batch, on the job system's workers
+    // and this thread. returns once all are lit. no chunk may be created or
+    // removed until then; the calling thread is the only one that could.
+    void lightChunks(const std::vector<ChunkPos> &chunks, JobSystem &jobs);
+
+    // queues a relight around a block edited with World::setBlock
+    void blockChanged(int x, int y, int z);
+    // relights every queued edit and returns how many blocks' light
+    // changed. sections whose light changed are marked dirty in the world.
+    size_t update();
+
+    // light at world coordinates. 15 sky light above the world, 0 for
+    // unloaded chunks and below it
+    uint8_t get(Channel channel, int x, int y, int z) const;
+
+private:
+
+    // lock stripes for lightChunks(), a chunk uses the one its key hashes to
+    static const int REGION_LOCKS = 64;
+
+    struct Batch;
+
+    struct Node {
+        int32_t x, z;
+        int16_t y;
+        // the level spreading from here, for darkening and border steps
+        uint8_t level;
+        // the Block::Face stepped through to get here
+        uint8_t face;
+    };
+
+    // a fifo that is cleared rather than popped, so memory is reused
+    struct Queue {
+        std::vector<Node> nodes;
+        size_t head = 0;
+
+        bool empty() const { return this->head == this->nodes.size(); }
+        void push(const Node &node) { this->nodes.push_back(node); }
+        Node pop() {
+            const Node node = this->nodes[this->head++];
+            if (this->head == this->nodes.size())
+                this->clear();
+            return node;
+        }
+        void clear() { this->nodes.clear(); this->head = 0; }
+    };
+
+    World &world;
+
+    Queue adds[CHANNEL_COUNT];
+    Queue removes[CHANNEL_COUNT];
+    // steps waiting to cross a chunk border
+    std::vector<Node> border;
+
+    // blocks edited since the last update()
+    std::vector<Node> edits;
+
+    std::unordered_set<SectionPos, SectionPosHash> changed;
+    SectionPos last_changed;
+    size_t changed_blocks;
+
+    // the chunk the last lookup landed in
+    Chunk *cached;
+    int32_t cached_x, cached_z;
+
+    // false for the engines lighting on workers, whose changed sections
+    // are collected by the engine that owns them instead
+    bool mark_dirty;
+    // per thread engines for lightChunks(), and the ones not in use
+    std::vector<std::unique_ptr<LightEngine>> helpers;
+    std::vector<LightEngine *> idle;
+    std::mutex helper_mutex;
+    std::mutex region_locks[REGION_LOCKS];
+
+    LightEngine *acquireHelper();
+    void releaseHelper(LightEngine *helper);
+    // lights chunks of a batch until none are left unclaimed. static since
+    // a job starting after the batch is done must not touch the engine
+    static void work(Batch &batch);
+
+    // marks the sections whose light changed dirty and forgets them
+    void flushChanged();
+
+    Chunk *chunkAt(int x, int z);
+    void resetCache();
+
+    void markChanged(int x, int y, int z);
+
+    // spreads light outwards from every queued node of channel
+    void propagate(Channel channel);
+    // darkens outwards from every queued removal of channel, queueing the
+    // light found at the edge of the dark area for propagate()
+    void darken(Channel channel);
+
+    // one propagation step into the block at node from light level
+    void spreadInto(Channel channel, Chunk *chunk, const Node &node, uint8_t level);
+    // one darkening step
+    void darkenInto(Channel channel, Chunk *chunk, const Node &node, uint8_t level);
+
+    // runs every waiting border step through step, grouped by chunk
+    template <typename Step>
+    void flushBorder(Step &&step);
+
+};
+
+#endif
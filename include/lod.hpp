@@ -0,0 +1,48 @@
+#ifndef LOD_H
+#define LOD_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "./config.hpp"
+#include "./world.hpp"
+
+// levels of detail, level n meshes from 2^n x 2^n x 2^n cells
+#define LOD_LEVELS 3
+
+static inline int lodScale(int lod) {
+    return 1 << lod;
+}
+
+// picks a level of detail for every section from its distance to the
+// camera. a section only changes level once it is LOD_HYSTERESIS chunks
+// past a boundary, so a camera moving back and forth across one doesn't
+// remesh the sections along it every time.
+class LodSelector {
+public:
+
+    // moves the camera, in block coordinates, and appends every section
+    // whose level changed to changed. those sections and their neighbours
+    // need remeshing. cheap when the camera stays inside one section.
+    void update(float x, float y, float z, std::vector<SectionPos> &changed);
+
+    // the section's level, choosing one if it's new
+    int level(SectionPos pos);
+    // bit per Block::Face whose neighbour is meshed at a different level
+    uint8_t skirts(SectionPos pos);
+
+    void erase(SectionPos pos);
+    void clear();
+
+private:
+
+    float x = 0.0f, y = 0.0f, z = 0.0f;
+    SectionPos camera = { 0, 0, 0 };
+    std::unordered_map<SectionPos, uint8_t, SectionPosHash> levels;
+
+    // level for pos from its distance, current is -1 for a new section
+    int choose(SectionPos pos, int current) const;
+
+};
+
+#endif
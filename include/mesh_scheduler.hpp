@@ -0,0 +1,63 @@
+#ifndef MESH_SCHEDULER_H
+#define MESH_SCHEDULER_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include "./job_system.hpp"
+#include "./mesher.hpp"
+#include "./mpsc_queue.hpp"
+#include "./visibility.hpp"
+#include "./world.hpp"
+
+struct MeshResult {
+    SectionPos pos;
+    uint32_t version;
+    ChunkMesh mesh;
+    // for the occlusion culling graph
+    FaceConnections faces;
+};
+
+// meshes dirty sections on the job system. each job works on its own copy of
+// the section and the sections around it, blocks and light, so the world can
+// keep changing while it runs. finished meshes come back through a lock-free queue that the
+// render thread drains.
+class MeshScheduler {
+public:
+
+    MeshScheduler(JobSystem &jobs);
+
+    // snapshots the section and its neighbours and queues a meshing job at
+    // level of detail lod, with skirts as PaddedSection::downsample takes
+    // them. a result from an earlier schedule() of the same section still
+    // in flight is dropped when it arrives.
+    void schedule(const World &world, SectionPos pos, int lod = 0, uint8_t skirts = 0);
+
+    // forgets a section, so meshes for it still in flight are dropped
+    void cancel(SectionPos pos);
+
+    // passes finished meshes to upload until budget_ns nanoseconds have
+    // passed, always handling at least one. returns how many were handled.
+    size_t drain(uint64_t budget_ns, const std::function<void(MeshResult &)> &upload);
+
+    // jobs scheduled but not yet drained
+    size_t inFlight() const;
+
+private:
+
+    JobSystem &jobs;
+    // shared with the jobs so a job finishing after the scheduler is gone
+    // still has somewhere to put its mesh
+    std::shared_ptr<MpscQueue<MeshResult>> finished;
+    // latest version scheduled per section, main thread only. versions are
+    // never reused, so a cancelled and rescheduled section can't mistake an
+    // old result for its own
+    std::unordered_map<SectionPos, uint32_t, SectionPosHash> versions;
+    uint32_t next_version;
+    std::atomic<size_t> in_flight;
+
+};
+
+#endif
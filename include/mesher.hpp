@@ -0,0 +1,126 @@
+#ifndef MESHER_H
+#define MESHER_H
+
+#include <cstdint>
+#include <vector>
+#include "./block.hpp"
+#include "./chunk.hpp"
+#include "./config.hpp"
+
+// a section's blocks plus a one block border copied from its neighbours,
+// so meshing never has to reach back into the world. the light of the same
+// blocks comes along for shading the corners of faces.
+class PaddedSection {
+public:
+
+    static const int SIZE = SECTION_SIZE + 2;
+    static const int VOLUME = SIZE * SIZE * SIZE;
+    // sections in the 3x3x3 block around and including this one
+    static const int NEIGHBOURHOOD = 27;
+
+    Block::BlockID blocks[VOLUME];
+    // the brighter of sky and block light of each block, 0 to 15
+    uint8_t light[VOLUME];
+    // whether faces get per corner occlusion and smooth light, or are all
+    // flat and fully lit. cleared for distant levels of detail
+    bool smooth;
+
+    // neighbours are indexed by Block::Face, a missing neighbour is air.
+    // the edges and corners of the border stay air and every block is fully
+    // lit, which is enough for the shape of the mesh
+    void load(const ChunkSection &center, const ChunkSection *const neighbours[Block::FACE_COUNT]);
+    // the whole border, edges and corners included, from the sections at
+    // each around() slot. the center must be present
+    void load(const ChunkSection *const sections[NEIGHBOURHOOD]);
+    // light from the same slots, a missing section counting as fully lit
+    void loadLight(const LightSection *const light[NEIGHBOURHOOD]);
+
+    // coarsens a loaded section for a distant level of detail. every
+    // scale^3 cell takes its majority block, air only winning outright
+    // majorities so thin ground doesn't vanish, and the mesher's greedy
+    // merging then turns each cell face into one quad. the border does the
+    // same with the neighbours' touching cells, except across faces set in
+    // skirts, whose neighbour is meshed at another level: those borders
+    // become air, so the section closes its side of the seam itself.
+    void downsample(int scale, uint8_t skirts, const ChunkSection *const neighbours[Block::FACE_COUNT]);
+
+    // coordinates run from -1 to SECTION_SIZE inclusive
+    static inline int index(int x, int y, int z) {
+        return ((y + 1) * SIZE + (z + 1)) * SIZE + (x + 1);
+    }
+
+    // slot of the section offset by dx, dy, dz (each -1 to 1), for load()
+    static inline int around(int dx, int dy, int dz) {
+        return ((dy + 1) * 3 + (dz + 1)) * 3 + (dx + 1);
+    }
+    // slot of the neighbour across a Block::Face
+    static int faceSlot(int face);
+
+    inline Block::BlockID get(int x, int y, int z) const {
+        return this->blocks[index(x, y, z)];
+    }
+
+};
+
+// a chunk vertex packed into 32 bits, unpacked again in shaders/shader.vert
+//
+//   bits  0-4   x       section-local position, 0 to SECTION_SIZE
+//   bits  5-9   y
+//   bits 10-14  z
+//   bits 15-17  face    Block::Face the quad belongs to, gives the normal
+//   bits 18-19  ao      ambient occlusion of the corner, 3 is unoccluded
+//   bits 20-23  light   smooth light of the corner, 15 is fully lit
+//   bits 24-31  tile    atlas tile
+//
+// texture coordinates aren't stored, the shader derives them from the
+// position so a merged quad repeats its tile once per block.
+struct ChunkVertex {
+    uint32_t data;
+
+    static inline ChunkVertex pack(int x, int y, int z, int face, int ao, int light, int tile) {
+        return { uint32_t(x) | uint32_t(y) << 5 | uint32_t(z) << 10 | uint32_t(face) << 15
+               | uint32_t(ao) << 18 | uint32_t(light) << 20 | uint32_t(tile) << 24 };
+    }
+
+    inline int x() const      { return this->data & 31; }
+    inline int y() const      { return (this->data >> 5) & 31; }
+    inline int z() const      { return (this->data >> 10) & 31; }
+    inline int face() const   { return (this->data >> 15) & 7; }
+    inline int ao() const     { return (this->data >> 18) & 3; }
+    inline int light() const  { return (this->data >> 20) & 15; }
+    inline int tile() const   { return this->data >> 24; }
+};
+
+static_assert(sizeof(ChunkVertex) == 4, "ChunkVertex must stay one 32-bit word");
+static_assert(SECTION_SIZE < 32, "ChunkVertex stores positions in 5 bits");
+
+// geometry for one section, ready to upload as one vertex and index buffer
+struct ChunkMesh {
+    std::vector<ChunkVertex> vertices;
+    std::vector<uint32_t> indices;
+
+    void clear();
+    size_t quads() const;
+};
+
+// every mesher shades the four corners of a face from the blocks in front
+// of it: ambient occlusion from the two blocks beside the corner and the
+// one diagonal to it, and light averaged over those of the four that aren't
+// opaque. faces are only merged when their corners shade alike, and each
+// quad is split along the diagonal that keeps the shading from streaking.
+
+// emits a quad for every visible face, merging runs of coplanar faces with
+// the same tile and shading into larger rectangles
+void greedyMesh(const PaddedSection &section, ChunkMesh &mesh);
+
+// produces the same quads as greedyMesh, but finds faces with shifts over one
+// 64-bit occupancy word per column and merges them with bit scans, so the
+// cost follows the number of faces rather than the number of blocks.
+// test/mesher_test.cpp holds it to that
+void binaryMesh(const PaddedSection &section, ChunkMesh &mesh);
+
+// one unmerged quad per visible face, visiting every block. the baseline the
+// other meshers are measured against
+void culledMesh(const PaddedSection &section, ChunkMesh &mesh);
+
+#endif
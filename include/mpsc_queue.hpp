@@ -0,0 +1,62 @@
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include <atomic>
+#include <utility>
+
+// unbounded lock-free queue for many producer threads and one consumer.
+// producers link a node onto the head with a single exchange; the consumer
+// walks from the tail and never contends with them.
+template <typename T>
+class MpscQueue {
+public:
+
+    MpscQueue() {
+        Node *stub = new Node();
+        this->head.store(stub, std::memory_order_relaxed);
+        this->tail = stub;
+    }
+
+    ~MpscQueue() {
+        T value;
+        while (this->pop(value)) {}
+        delete this->tail;
+    }
+
+    MpscQueue(const MpscQueue &) = delete;
+    MpscQueue &operator=(const MpscQueue &) = delete;
+
+    // safe from any thread
+    void push(T value) {
+        Node *node = new Node();
+        node->value = std::move(value);
+        Node *prev = this->head.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    // consumer thread only. may briefly report empty while a push is
+    // halfway through linking its node.
+    bool pop(T &out) {
+        Node *next = this->tail->next.load(std::memory_order_acquire);
+        if (!next)
+            return false;
+
+        out = std::move(next->value);
+        delete this->tail;
+        this->tail = next;
+        return true;
+    }
+
+private:
+
+    struct Node {
+        std::atomic<Node *> next{nullptr};
+        T value;
+    };
+
+    std::atomic<Node *> head;
+    Node *tail;
+
+};
+
+#endif
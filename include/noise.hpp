@@ -0,0 +1,47 @@
+#ifndef NOISE_H
+#define NOISE_H
+
+#include <cstddef>
+#include <cstdint>
+
+// seeded 2D and 3D gradient noise, evaluated over arrays of points so the
+// lattice hashing and interpolation run several points per instruction.
+// the kernel is written once against a small set of vector operations and
+// built for plain floats, SSE2 and AVX2; the widest one the cpu supports is
+// picked at startup. every path does the same float operations in the same
+// order (no fused multiply-add, no reassociation), so a seed generates the
+// same world bit for bit whichever path runs it.
+class Noise {
+public:
+
+    enum Path { SCALAR, SSE2, AVX2, PATH_COUNT };
+
+    // the widest path this cpu can run
+    static Path best();
+    // the path the functions below use
+    static Path path();
+    // switches path, falling back to the widest supported one at or below
+    // it, and returns the path now in use. not thread safe, only call while
+    // no noise is being evaluated.
+    static Path setPath(Path path);
+    static const char *name(Path path);
+
+    // adds amplitude * noise(x * frequency, y * frequency) to out for count
+    // points. noise is 0 on integer lattice points and stays within about
+    // [-1, 1]
+    static void add2(const float *x, const float *y, size_t count, uint32_t seed,
+                     float frequency, float amplitude, float *out);
+    static void add3(const float *x, const float *y, const float *z, size_t count, uint32_t seed,
+                     float frequency, float amplitude, float *out);
+
+    // octaves of noise summed into out, which is overwritten. each octave
+    // doubles the frequency, multiplies the amplitude by gain and uses its
+    // own seed. the result is normalized back to about [-1, 1]
+    static void fractal2(const float *x, const float *y, size_t count, uint32_t seed,
+                         float frequency, int octaves, float gain, float *out);
+    static void fractal3(const float *x, const float *y, const float *z, size_t count, uint32_t seed,
+                         float frequency, int octaves, float gain, float *out);
+
+};
+
+#endif
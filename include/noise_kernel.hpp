@@ -0,0 +1,120 @@
+// the gradient noise kernels, shared by every instruction set. noise.cpp
+// includes this once per path, inside a namespace defining the lane types F
+// (WIDTH floats) and I (WIDTH 32 bit ints) and the operations used below, so
+// there is deliberately no include guard. everything here must stay exact:
+// the same float operations in the same order on every path.
+
+// large odd constants spreading neighbouring lattice coordinates apart
+static const uint32_t PRIME_X = 0x8DA6B343;
+static const uint32_t PRIME_Y = 0xD8163841;
+static const uint32_t PRIME_Z = 0xCB1AB31F;
+
+// 6t^5 - 15t^4 + 10t^3, flat at both ends so lattice cells join smoothly
+static inline F fade(F t) {
+    return mul(mul(mul(t, t), t), add(mul(t, sub(mul(t, set(6.0f)), set(15.0f))), set(10.0f)));
+}
+
+static inline F lerp(F a, F b, F t) {
+    return add(a, mul(t, sub(b, a)));
+}
+
+// mixes the combined lattice coordinates so every bit of the hash depends
+// on all of them
+static inline I avalanche(I h) {
+    h = xori(h, srli(h, 15));
+    h = muli(h, seti(0x2C1B3C6D));
+    return xori(h, srli(h, 12));
+}
+
+// v with its sign flipped wherever the top bit of bits is set
+static inline F flip(F v, I bits) {
+    return xorf(v, andi(bits, seti(0x80000000)));
+}
+
+// offset from a lattice corner dotted with the corner's gradient, one of
+// the four diagonals picked by the low two bits of the hash
+static inline F grad2(I h, F x, F y) {
+    return add(flip(x, slli(h, 31)), flip(y, slli(h, 30)));
+}
+
+// the same in 3D, with the twelve cube edge directions (four repeated to
+// make sixteen) as in improved Perlin noise
+static inline F grad3(I h, F x, F y, F z) {
+    const I low = andi(h, seti(15));
+    const F u = select(cmplt(low, seti(8)), x, y);
+    const F v = select(cmplt(low, seti(4)), y, select(cmpeq(andi(low, seti(13)), seti(12)), x, z));
+    return add(flip(u, slli(h, 31)), flip(v, slli(h, 30)));
+}
+
+// floor as an integer, from truncation corrected for negative inputs
+static inline I floori(F v) {
+    const I t = truncate(v);
+    return addi(t, cmpgt(tofloat(t), v));
+}
+
+// both kernels handle whole groups of WIDTH points and return how many
+// points they covered, the caller finishes the rest one at a time
+static size_t add2(const float *px, const float *py, size_t count, uint32_t seed,
+                   float frequency, float amplitude, float *out) {
+    const F freq = set(frequency), amp = set(amplitude), one = set(1.0f);
+    const I s = seti(seed), prime_x = seti(PRIME_X), prime_y = seti(PRIME_Y);
+
+    size_t i = 0;
+    for (; i + WIDTH <= count; i += WIDTH) {
+        const F x = mul(load(px + i), freq);
+        const F y = mul(load(py + i), freq);
+        const I xi = floori(x), yi = floori(y);
+        const F fx = sub(x, tofloat(xi)), fy = sub(y, tofloat(yi));
+
+        // (x + 1) * prime is x * prime + prime, wrapping the same way
+        const I hx0 = muli(xi, prime_x), hx1 = addi(hx0, prime_x);
+        const I hy0 = xori(muli(yi, prime_y), s), hy1 = xori(addi(muli(yi, prime_y), prime_y), s);
+
+        const F fx1 = sub(fx, one), fy1 = sub(fy, one);
+        const F n00 = grad2(avalanche(xori(hx0, hy0)), fx, fy);
+        const F n10 = grad2(avalanche(xori(hx1, hy0)), fx1, fy);
+        const F n01 = grad2(avalanche(xori(hx0, hy1)), fx, fy1);
+        const F n11 = grad2(avalanche(xori(hx1, hy1)), fx1, fy1);
+
+        const F u = fade(fx), v = fade(fy);
+        const F n = lerp(lerp(n00, n10, u), lerp(n01, n11, u), v);
+        store(out + i, add(load(out + i), mul(n, amp)));
+    }
+    return i;
+}
+
+static size_t add3(const float *px, const float *py, const float *pz, size_t count, uint32_t seed,
+                   float frequency, float amplitude, float *out) {
+    const F freq = set(frequency), amp = set(amplitude), one = set(1.0f);
+    const I s = seti(seed), prime_x = seti(PRIME_X), prime_y = seti(PRIME_Y), prime_z = seti(PRIME_Z);
+
+    size_t i = 0;
+    for (; i + WIDTH <= count; i += WIDTH) {
+        const F x = mul(load(px + i), freq);
+        const F y = mul(load(py + i), freq);
+        const F z = mul(load(pz + i), freq);
+        const I xi = floori(x), yi = floori(y), zi = floori(z);
+        const F fx = sub(x, tofloat(xi)), fy = sub(y, tofloat(yi)), fz = sub(z, tofloat(zi));
+
+        const I hx0 = muli(xi, prime_x), hx1 = addi(hx0, prime_x);
+        const I hy0 = muli(yi, prime_y), hy1 = addi(hy0, prime_y);
+        const I hz0 = xori(muli(zi, prime_z), s), hz1 = xori(addi(muli(zi, prime_z), prime_z), s);
+        const I h00 = xori(hy0, hz0), h10 = xori(hy1, hz0), h01 = xori(hy0, hz1), h11 = xori(hy1, hz1);
+
+        const F fx1 = sub(fx, one), fy1 = sub(fy, one), fz1 = sub(fz, one);
+        const F n000 = grad3(avalanche(xori(hx0, h00)), fx, fy, fz);
+        const F n100 = grad3(avalanche(xori(hx1, h00)), fx1, fy, fz);
+        const F n010 = grad3(avalanche(xori(hx0, h10)), fx, fy1, fz);
+        const F n110 = grad3(avalanche(xori(hx1, h10)), fx1, fy1, fz);
+        const F n001 = grad3(avalanche(xori(hx0, h01)), fx, fy, fz1);
+        const F n101 = grad3(avalanche(xori(hx1, h01)), fx1, fy, fz1);
+        const F n011 = grad3(avalanche(xori(hx0, h11)), fx, fy1, fz1);
+        const F n111 = grad3(avalanche(xori(hx1, h11)), fx1, fy1, fz1);
+
+        const F u = fade(fx), v = fade(fy), w = fade(fz);
+        const F n = lerp(lerp(lerp(n000, n100, u), lerp(n010, n110, u), v),
+                         lerp(lerp(n001, n101, u), lerp(n011, n111, u), v), w);
+        store(out + i, add(load(out + i), mul(n, amp)));
+    }
+    return i;
+}
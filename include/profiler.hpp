@@ -0,0 +1,139 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "./clock.hpp"
+
+// one timed scope or counter sample, as written by the thread it happened on
+struct ProfileEvent {
+    enum Kind : uint8_t { ZONE, COUNTER };
+
+    uint64_t start;
+    // end time for zones, the added amount for counters
+    uint64_t end;
+    uint16_t id;
+    Kind kind;
+};
+
+// min, average and 99th percentile of a zone's total time per frame, or of
+// a counter's per-frame sum, over the last PROFILER_HISTORY frames
+struct ProfileStats {
+    std::string name;
+    bool counter;
+    double last, min, avg, p99;
+};
+
+// in-process instrumentation. every thread writes its events into its own
+// lock-free ring buffer; once a frame the main thread drains all of them and
+// folds the events into per-frame totals.
+class Profiler {
+public:
+
+    // returns the id for a zone or counter name, registering it if new.
+    // takes a lock, so call it once per site (the macros below do)
+    static uint16_t zone(const char *name);
+    static uint16_t counter(const char *name);
+
+    // names the calling thread in reports and traces
+    static void setThreadName(const std::string &name);
+
+    static inline void record(uint16_t id, uint64_t start, uint64_t end, ProfileEvent::Kind kind);
+
+    // main thread, once per frame: drains every thread's events and closes
+    // the frame's totals
+    static void endFrame();
+
+    static std::vector<ProfileStats> stats();
+    // the stats table, then the events dropped so far
+    static void print(std::ostream &out);
+
+    // events lost to full buffers since startup, over every thread
+    static uint64_t dropped();
+
+    // keeps every event of the next frames frames, from every thread, and
+    // then writes them to path as a Chrome Trace Event Format JSON file for
+    // chrome://tracing or ui.perfetto.dev. zones are always recorded, so a
+    // capture only adds copying events in endFrame() and the final write.
+    // a capture of 0 frames cancels the running one
+    static void startCapture(uint32_t frames, const std::string &path);
+    static bool capturing();
+
+    // writes events as trace JSON, timestamps relative to origin_ns.
+    // dropped holds the events each thread lost during the capture, by
+    // thread index, and becomes a counter so missing data shows up
+    static void writeTrace(std::ostream &out, const std::vector<ProfileEvent> &events,
+                           const std::vector<uint32_t> &threads, uint64_t origin_ns,
+                           const std::vector<uint64_t> &dropped = std::vector<uint64_t>());
+
+};
+
+// times the enclosing scope
+class ProfileScope {
+public:
+
+    inline ProfileScope(uint16_t id) : id(id), start(monotonicNs()) {}
+    inline ~ProfileScope() { Profiler::record(this->id, this->start, monotonicNs(), ProfileEvent::ZONE); }
+
+private:
+
+    uint16_t id;
+    uint64_t start;
+
+};
+
+/* -------------------------------------------------------------------------- */
+// single-producer ring of events owned by one thread, drained by the main
+// thread. events arriving while it's full are counted and dropped.
+struct ProfileBuffer {
+    static const uint32_t CAPACITY = 1 << 13;
+
+    ProfileEvent events[CAPACITY];
+    std::atomic<uint64_t> head{0}, tail{0};
+    std::atomic<uint64_t> dropped{0};
+    uint32_t thread_index;
+    std::string thread_name;
+
+    inline void push(const ProfileEvent &event) {
+        const uint64_t head = this->head.load(std::memory_order_relaxed);
+        if (head - this->tail.load(std::memory_order_acquire) >= CAPACITY) {
+            this->dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        this->events[head & (CAPACITY - 1)] = event;
+        this->head.store(head + 1, std::memory_order_release);
+    }
+};
+
+// the calling thread's buffer, created on its first event
+ProfileBuffer *registerProfileThread();
+inline thread_local ProfileBuffer *profile_thread_buffer = nullptr;
+
+inline void Profiler::record(uint16_t id, uint64_t start, uint64_t end, ProfileEvent::Kind kind) {
+    if (!profile_thread_buffer)
+        profile_thread_buffer = registerProfileThread();
+    profile_thread_buffer->push({ start, end, id, kind });
+}
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+
+// PROFILE_ZONE("name") times the rest of the enclosing scope.
+// PROFILE_COUNT("name", n) adds n to a counter summed per frame.
+#ifndef DISABLE_PROFILER
+#define PROFILE_ZONE(name) \
+    static const uint16_t PROFILE_CONCAT(profile_zone_, __LINE__) = Profiler::zone(name); \
+    ProfileScope PROFILE_CONCAT(profile_scope_, __LINE__)(PROFILE_CONCAT(profile_zone_, __LINE__))
+#define PROFILE_COUNT(name, n) do { \
+        static const uint16_t profile_counter = Profiler::counter(name); \
+        Profiler::record(profile_counter, monotonicNs(), (uint64_t)(n), ProfileEvent::COUNTER); \
+    } while (0)
+#else
+#define PROFILE_ZONE(name)
+#define PROFILE_COUNT(name, n) do {} while (0)
+#endif
+
+#endif
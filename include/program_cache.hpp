@@ -0,0 +1,40 @@
+#ifndef PROGRAM_CACHE_H
+#define PROGRAM_CACHE_H
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <string>
+
+// saves linked shader programs to disk with glGetProgramBinary so later
+// launches can skip compiling. entries are keyed by a hash of the sources,
+// the defines and the driver's vendor, renderer and version strings, so a
+// driver update or an edited shader just misses and recompiles.
+//
+// glad is generated for GL 3.3, which lacks program binaries, so the entry
+// points come from GL 4.1 or ARB_get_program_binary at runtime. without
+// either the cache does nothing.
+class ProgramCache {
+public:
+
+    // true if the driver can save and load program binaries. needs a
+    // current GL context.
+    static bool supported();
+
+    // cache key for a program built from these sources
+    static uint64_t key(const std::string &vertex, const std::string &fragment,
+                        const std::string &defines);
+
+    // creates a program from the binary cached under key, or returns 0 if
+    // there is none or the driver rejects it
+    static GLuint load(uint64_t key);
+
+    // asks the driver to keep program's binary retrievable, call before
+    // linking a program that will be saved
+    static void prepare(GLuint program);
+
+    // writes a successfully linked program's binary under key
+    static void save(uint64_t key, GLuint program);
+
+};
+
+#endif
@@ -8,14 +8,19 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include "./config.hpp"
+#include "./program_cache.hpp"
+#include "./uniform_table.hpp"
 
 class Shader
 {
 public:
     unsigned int ID;
-    // constructor generates the shader on the fly
+    // constructor generates the shader on the fly, or loads it from the
+    // program cache if these exact sources were built before. defines are
+    // "#define" lines inserted after each source's #version line.
     // ------------------------------------------------------------------------
-    Shader(const char* vertexPath, const char* fragmentPath)
+    Shader(const char* vertexPath, const char* fragmentPath, const std::string &defines = "")
     {
         // 1. retrieve the vertex/fragment source code from filePath
         std::string vertexCode;
@@ -45,6 +50,18 @@ public:
         {
             std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ" << std::endl;
         }
+        vertexCode = addDefines(vertexCode, defines);
+        fragmentCode = addDefines(fragmentCode, defines);
+
+        // skip compiling entirely if the driver kept a binary of this build
+        const uint64_t cacheKey = ProgramCache::key(vertexCode, fragmentCode, defines);
+        ID = ProgramCache::load(cacheKey);
+        if (ID != 0)
+        {
+            reflect();
+            return;
+        }
+
         const char* vShaderCode = vertexCode.c_str();
         const char * fShaderCode = fragmentCode.c_str();
         // 2. compile shaders
@@ -63,12 +80,17 @@ public:
         ID = glCreateProgram();
         glAttachShader(ID, vertex);
         glAttachShader(ID, fragment);
+        ProgramCache::prepare(ID);
         glLinkProgram(ID);
         checkCompileErrors(ID, "PROGRAM");
+        GLint linked = 0;
+        glGetProgramiv(ID, GL_LINK_STATUS, &linked);
+        if (linked)
+            ProgramCache::save(cacheKey, ID);
         // delete the shaders as they're linked into our program now and no longer necessery
         glDeleteShader(vertex);
         glDeleteShader(fragment);
-
+        reflect();
     }
     // activate the shader
     // ------------------------------------------------------------------------
@@ -76,66 +98,140 @@ public:
     { 
         glUseProgram(ID); 
     }
+    // location of an active uniform, -1 if the program doesn't use it. the
+    // set functions below look names up the same way; hoist the location
+    // out of a loop that sets the same uniform many times.
+    // ------------------------------------------------------------------------
+    GLint location(const std::string &name) const
+    {
+        return uniforms.find(name);
+    }
+    // connects a uniform block to a buffer binding point, ignored if the
+    // program has no block by that name
+    // ------------------------------------------------------------------------
+    void bindBlock(const std::string &name, GLuint binding) const
+    {
+        const GLint index = blocks.find(name);
+        if (index >= 0)
+            glUniformBlockBinding(ID, index, binding);
+    }
     // utility uniform functions
     // ------------------------------------------------------------------------
     void setBool(const std::string &name, bool value) const
     {         
-        glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value); 
+        glUniform1i(uniforms.find(name), (int)value); 
     }
     // ------------------------------------------------------------------------
     void setInt(const std::string &name, int value) const
     { 
-        glUniform1i(glGetUniformLocation(ID, name.c_str()), value); 
+        glUniform1i(uniforms.find(name), value); 
     }
     // ------------------------------------------------------------------------
     void setFloat(const std::string &name, float value) const
     { 
-        glUniform1f(glGetUniformLocation(ID, name.c_str()), value); 
+        glUniform1f(uniforms.find(name), value); 
     }
     // ------------------------------------------------------------------------
     void setVec2(const std::string &name, const glm::vec2 &value) const
     { 
-        glUniform2fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]); 
+        glUniform2fv(uniforms.find(name), 1, &value[0]); 
     }
     void setVec2(const std::string &name, float x, float y) const
     { 
-        glUniform2f(glGetUniformLocation(ID, name.c_str()), x, y); 
+        glUniform2f(uniforms.find(name), x, y); 
     }
     // ------------------------------------------------------------------------
     void setVec3(const std::string &name, const glm::vec3 &value) const
     { 
-        glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]); 
+        glUniform3fv(uniforms.find(name), 1, &value[0]); 
     }
     void setVec3(const std::string &name, float x, float y, float z) const
     { 
-        glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z); 
+        glUniform3f(uniforms.find(name), x, y, z); 
     }
     // ------------------------------------------------------------------------
     void setVec4(const std::string &name, const glm::vec4 &value) const
     { 
-        glUniform4fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]); 
+        glUniform4fv(uniforms.find(name), 1, &value[0]); 
     }
     void setVec4(const std::string &name, float x, float y, float z, float w) const
     { 
-        glUniform4f(glGetUniformLocation(ID, name.c_str()), x, y, z, w); 
+        glUniform4f(uniforms.find(name), x, y, z, w); 
     }
     // ------------------------------------------------------------------------
     void setMat2(const std::string &name, const glm::mat2 &mat) const
     {
-        glUniformMatrix2fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        glUniformMatrix2fv(uniforms.find(name), 1, GL_FALSE, &mat[0][0]);
     }
     // ------------------------------------------------------------------------
     void setMat3(const std::string &name, const glm::mat3 &mat) const
     {
-        glUniformMatrix3fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        glUniformMatrix3fv(uniforms.find(name), 1, GL_FALSE, &mat[0][0]);
     }
     // ------------------------------------------------------------------------
     void setMat4(const std::string &name, const glm::mat4 &mat) const
     {
-        glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        glUniformMatrix4fv(uniforms.find(name), 1, GL_FALSE, &mat[0][0]);
+    }
+    void setMat4(GLint location, const glm::mat4 &mat) const
+    {
+        glUniformMatrix4fv(location, 1, GL_FALSE, &mat[0][0]);
     }
 
 private:
+    // active uniforms of the linked program, by name
+    UniformTable uniforms;
+    // active uniform block indices, by block name
+    UniformTable blocks;
+
+    // fills the uniform and block tables once after linking, and points the
+    // program's Frame block, if it has one, at the shared per-frame buffer
+    // ------------------------------------------------------------------------
+    void reflect()
+    {
+        GLint count = 0, length = 0;
+        glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+        glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &length);
+        std::string name(length, '\0');
+        for (GLint i = 0; i < count; i++)
+        {
+            GLsizei written = 0;
+            GLint size;
+            GLenum type;
+            glGetActiveUniform(ID, i, length, &written, &size, &type, &name[0]);
+            const std::string uniform = name.substr(0, written);
+            // members of uniform blocks have no location
+            const GLint location = glGetUniformLocation(ID, uniform.c_str());
+            if (location < 0)
+                continue;
+            uniforms.insert(uniform, location);
+            // arrays are reported as "name[0]", also accept the bare name
+            if (uniform.size() > 3 && uniform.compare(uniform.size() - 3, 3, "[0]") == 0)
+                uniforms.insert(uniform.substr(0, uniform.size() - 3), location);
+        }
+
+        glGetProgramiv(ID, GL_ACTIVE_UNIFORM_BLOCKS, &count);
+        glGetProgramiv(ID, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &length);
+        name.assign(length, '\0');
+        for (GLint i = 0; i < count; i++)
+        {
+            GLsizei written = 0;
+            glGetActiveUniformBlockName(ID, i, length, &written, &name[0]);
+            blocks.insert(name.substr(0, written), i);
+        }
+
+        bindBlock("Frame", FRAME_UNIFORM_BINDING);
+    }
+    // inserts defines after the #version line, which has to come first
+    // ------------------------------------------------------------------------
+    static std::string addDefines(const std::string &code, const std::string &defines)
+    {
+        if (defines.empty())
+            return code;
+        size_t line = code.find('\n');
+        line = line == std::string::npos ? code.size() : line + 1;
+        return code.substr(0, line) + defines + "\n" + code.substr(line);
+    }
     // utility function for checking shader compilation/linking errors.
     // ------------------------------------------------------------------------
     void checkCompileErrors(GLuint shader, std::string type)
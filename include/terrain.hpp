@@ -0,0 +1,46 @@
+#ifndef TERRAIN_H
+#define TERRAIN_H
+
+#include <cstdint>
+#include "./chunk.hpp"
+
+// fills chunk columns from seeded noise: a height field of large rolling
+// shapes plus smaller detail, stone under a few blocks of dirt topped with
+// grass (sand along the shore), water up to sea level and tunnels carved
+// where two 3D noise fields both cross zero. the same seed always gives the
+// same world, whichever noise path runs it. generate() only reads the
+// generator, so workers can share one.
+class TerrainGenerator {
+public:
+
+    static const int SEA_LEVEL = 62;
+
+    // how the 3D cave fields are evaluated. FULL runs the noise at every
+    // block; COARSE runs it on a lattice every 4x8x4 blocks and fills the
+    // blocks between by trilinear interpolation, about 55 times fewer
+    // noise evaluations for tunnels of the same shape
+    enum Sampling { FULL, COARSE };
+
+    uint32_t seed;
+    Sampling sampling;
+
+    explicit TerrainGenerator(uint32_t seed, Sampling sampling = COARSE);
+
+    // overwrites every section of chunk, placed by chunk.x and chunk.z
+    void generate(Chunk &chunk) const;
+
+    // y of the top solid block of the column at world x, z, ignoring caves
+    int height(int x, int z) const;
+
+    // both cave fields for every block of section sy of chunk (cx, cz), in
+    // ChunkSection::index() order
+    void caveFields(int32_t cx, int sy, int32_t cz, float *a, float *b) const;
+
+private:
+
+    // surface heights of the 16x16 columns of chunk (cx, cz), x fastest
+    void heights(int32_t cx, int32_t cz, int *out) const;
+
+};
+
+#endif
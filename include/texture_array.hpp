@@ -0,0 +1,43 @@
+#ifndef TEXTURE_ARRAY_H
+#define TEXTURE_ARRAY_H
+
+#include <glad/glad.h>
+#include <cstdint>
+
+// a tile atlas cut into a GL_TEXTURE_2D_ARRAY with one layer per tile. each
+// layer gets its own mipmap chain, so distant faces never blend in texels
+// from the neighbouring tiles and texture coordinates can repeat across a
+// merged quad. layer n is tile n, counted row by row from the top left.
+class TextureArray {
+public:
+
+    unsigned int ID;
+    int tile_width, tile_height, layers;
+
+    TextureArray();
+
+    // layers of a single texel of one colour, 0xAABBGGRR, as a stand-in
+    // while the real texture loads
+    void solid(int layers, uint32_t rgba);
+
+    // storage for layers tiles, contents undefined until uploaded
+    void allocate(int tile_width, int tile_height, int layers);
+    // copies count whole layers starting at first. pixels is a pointer, or
+    // an offset while a GL_PIXEL_UNPACK_BUFFER is bound
+    void uploadLayers(int first, int count, const void *pixels);
+    // builds the mipmap chains once every layer is uploaded
+    void finish();
+
+    void bind(unsigned int unit) const;
+
+    void destroy();
+
+    // rearranges a top-to-bottom RGBA atlas into columns * rows tiles of
+    // contiguous rows, bottom row first as GL expects, ready for
+    // uploadLayers(). out holds width * height * 4 bytes.
+    static void slice(const unsigned char *atlas, int width, int height,
+                      int columns, int rows, unsigned char *out);
+
+};
+
+#endif
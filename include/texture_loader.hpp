@@ -0,0 +1,89 @@
+#ifndef TEXTURE_LOADER_H
+#define TEXTURE_LOADER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "./job_system.hpp"
+#include "./mpsc_queue.hpp"
+#include "./texture_array.hpp"
+
+// decoded pixels handed from a worker to the render thread
+struct DecodedImage {
+    uint32_t request;
+    bool ok;
+    int tile_width, tile_height, layers;
+    std::vector<unsigned char> pixels;
+};
+
+// loads textures without stalling the render thread. images decode and are
+// sliced on the job system into pooled buffers; the render thread then
+// streams them to the GPU a few layers a frame through a pair of reused
+// pixel buffer objects, and hands each finished texture to its callback.
+class TextureLoader {
+public:
+
+    typedef std::function<void(TextureArray)> Callback;
+
+    TextureLoader(JobSystem &jobs);
+
+    // queues path, an atlas of columns x rows tiles, for loading. done runs
+    // on the render thread from update() and takes ownership of the
+    // finished texture. failed loads never call done.
+    void loadArray(const std::string &path, int columns, int rows, Callback done);
+
+    // render thread, once a frame: uploads at most budget_bytes of decoded
+    // pixels, always at least one layer if any are waiting. returns the
+    // bytes uploaded.
+    size_t update(size_t budget_bytes);
+
+    // loads queued and not yet handed to their callback
+    size_t pending() const;
+
+    // frees the pixel buffers and any half-uploaded textures. needs a
+    // current GL context.
+    void destroy();
+
+private:
+
+    // an image being streamed to the GPU over several frames
+    struct Upload {
+        DecodedImage image;
+        TextureArray texture;
+        int next_layer;
+        Callback done;
+    };
+
+    // decode buffers recycled between loads, shared with the jobs
+    struct PixelPool {
+        std::mutex mutex;
+        std::vector<std::vector<unsigned char>> free;
+    };
+
+    JobSystem &jobs;
+    std::shared_ptr<MpscQueue<DecodedImage>> decoded;
+    std::shared_ptr<PixelPool> pool;
+    // request id -> callback, for loads still decoding
+    std::deque<std::pair<uint32_t, Callback>> waiting;
+    std::deque<Upload> uploads;
+    uint32_t next_request;
+
+    // uploads alternate between these so writing one frame's pixels never
+    // waits on the GPU still reading the last frame's
+    unsigned int pbos[2];
+    size_t pbo_size[2];
+    int next_pbo;
+
+    void streamLayers(Upload &upload, int count);
+    // returns a decode buffer to the pool for the next load
+    void recycle(std::vector<unsigned char> &pixels);
+
+};
+
+#endif
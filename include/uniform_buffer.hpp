@@ -0,0 +1,47 @@
+#ifndef UNIFORM_BUFFER_H
+#define UNIFORM_BUFFER_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstddef>
+
+// per-frame values shared by every program through the std140 block
+//
+//   layout (std140) uniform Frame {
+//       mat4 view;
+//       mat4 projection;
+//       vec4 camera;
+//   };
+//
+// the members are already 16-byte aligned, so this matches std140 exactly
+struct FrameUniforms {
+    glm::mat4 view;
+    glm::mat4 projection;
+    // xyz camera position, w seconds since the window opened
+    glm::vec4 camera;
+};
+
+static_assert(sizeof(FrameUniforms) == 144, "FrameUniforms must match the std140 Frame block");
+
+// a uniform buffer object bound to a fixed binding point, which programs
+// connect their blocks to once with Shader::bindBlock()
+class UniformBuffer {
+public:
+
+    unsigned int ID;
+    size_t size;
+
+    UniformBuffer();
+
+    // allocates size bytes and binds them to binding. needs a current GL
+    // context.
+    void create(size_t size, unsigned int binding);
+
+    // overwrites the start of the buffer
+    void update(const void *data, size_t bytes);
+
+    void destroy();
+
+};
+
+#endif
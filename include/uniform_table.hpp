@@ -0,0 +1,52 @@
+#ifndef UNIFORM_TABLE_H
+#define UNIFORM_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// FNV-1a hash of a uniform name
+static inline uint32_t uniformHash(const char *name) {
+    uint32_t hash = 2166136261u;
+    while (*name)
+        hash = (hash ^ uint8_t(*name++)) * 16777619u;
+    return hash;
+}
+
+// name -> location map filled once from a linked program's active uniforms.
+// open addressing over a power of two table kept at most half full, so a
+// lookup is one hash of the name and usually a single probe, instead of the
+// driver's string search in glGetUniformLocation.
+class UniformTable {
+public:
+
+    // adds or replaces name's location
+    void insert(const std::string &name, int location);
+
+    // -1 for names that aren't in the table, which glUniform* ignores just
+    // like a location glGetUniformLocation couldn't find
+    int find(const char *name) const;
+    int find(const std::string &name) const;
+
+    void clear();
+    size_t size() const;
+
+private:
+
+    // slots only hold the hash and an index into names, keeping the probed
+    // array small. empty slots have a negative name index
+    struct Slot {
+        uint32_t hash;
+        int32_t name;
+        int32_t location;
+    };
+
+    std::vector<Slot> slots;
+    std::vector<std::string> names;
+
+    void grow();
+
+};
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef VISIBILITY_H
+#define VISIBILITY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "./block.hpp"
+#include "./chunk.hpp"
+#include "./frustum.hpp"
+#include "./world.hpp"
+
+// which faces of a section can see each other through its non-opaque
+// blocks, bit a * 6 + b set (along with b * 6 + a) when faces a and b are
+// connected. a fully open section connects every pair.
+typedef uint64_t FaceConnections;
+
+static inline bool facesConnected(FaceConnections faces, int a, int b) {
+    return (faces >> (a * Block::FACE_COUNT + b)) & 1;
+}
+
+// flood fills the section's see-through blocks from its borders and records
+// every pair of faces the same open region touches. run at mesh time.
+FaceConnections sectionConnections(const ChunkSection &section);
+
+// occlusion culling without GPU queries. each frame a breadth-first search
+// walks from the camera's section to its neighbours, only crossing a
+// section from the face it entered by to faces that face connects to, and
+// never turning back towards the camera. sections the search can't reach
+// are hidden behind solid ground, whatever the frustum says.
+class VisibilityGraph {
+public:
+
+    void set(SectionPos pos, FaceConnections faces);
+    void erase(SectionPos pos);
+    void clear();
+    size_t size() const;
+
+    // marks every section a line of sight from start could reach inside
+    // frustum, returning how many. if start isn't in the graph (the camera
+    // is outside the loaded world) everything counts as reached.
+    size_t traverse(SectionPos start, const Frustum &frustum);
+
+    // whether the last traverse() reached pos
+    bool reached(SectionPos pos) const;
+
+private:
+
+    struct Node {
+        FaceConnections faces;
+        // traversal that last reached this node
+        uint32_t visited;
+    };
+
+    struct Step {
+        SectionPos pos;
+        FaceConnections faces;
+        // face the search came in through, -1 at the start
+        int8_t entered;
+        // bit per face direction taken so far
+        uint8_t directions;
+    };
+
+    std::unordered_map<SectionPos, Node, SectionPosHash> nodes;
+    std::vector<Step> queue;
+    uint32_t traversal = 0;
+    bool everything = true;
+
+};
+
+#endif
@@ -11,8 +11,27 @@
 #include <glm/gtc/type_ptr.hpp>
 #include <iostream>
 #include <stdint.h>
+#include <unordered_map>
+#include <vector>
+#include "./camera.hpp"
+#include "./chunk_arena.hpp"
+#include "./chunk_manager.hpp"
+#include "./clock.hpp"
 #include "./config.hpp"
+#include "./fixed_timestep.hpp"
+#include "./frustum.hpp"
+#include "./job_system.hpp"
+#include "./light_engine.hpp"
+#include "./lod.hpp"
+#include "./mesh_scheduler.hpp"
+#include "./profiler.hpp"
 #include "./shader.hpp"
+#include "./terrain.hpp"
+#include "./texture_array.hpp"
+#include "./texture_loader.hpp"
+#include "./uniform_buffer.hpp"
+#include "./visibility.hpp"
+#include "./world.hpp"
 
 const unsigned int width = SCR_WIDTH, height = SCR_HEIGHT;
 
@@ -22,11 +41,49 @@ public:
     GLFWwindow *handle;
     glm::vec2 size;
 
-    uint64_t last_second;
+    // timestamps and deltas are monotonicNs() nanoseconds. frames and ticks
+    // count up during a second, fps and tps hold the last second's totals
+    uint64_t start_time, last_second;
     uint64_t frames, fps, last_frame, frame_delta;
-    uint64_t ticks, tps, tick_remainder;
-
-    unsigned int VAO, texture;
+    uint64_t ticks, tps;
+    // prints the profiler's zone table once a second, toggled with F3
+    bool show_profiler;
+    FixedTimestep timestep;
+
+    unsigned int VAO;
+    // block textures, one layer per atlas tile. a flat placeholder until
+    // the loader delivers the atlas
+    TextureArray blocks;
+
+    Shader *shader;
+    // view, projection and camera for every program, see FrameUniforms
+    UniformBuffer frame_uniforms;
+    Camera camera;
+    // camera position as of the previous tick, rendering interpolates from
+    // here to camera.position by timestep.alpha()
+    glm::vec3 camera_prev;
+    glm::vec2 last_mouse;
+    bool first_mouse;
+
+    World world;
+    TerrainGenerator terrain;
+    LightEngine light;
+    // declared before meshes so its workers outlive the scheduler
+    JobSystem jobs;
+    MeshScheduler meshes;
+    TextureLoader textures;
+    // every section's mesh, in shared GPU buffers
+    ChunkArena arena;
+    // bounds of every section in the arena, and the ones that passed this
+    // frame's frustum test
+    SectionBounds bounds;
+    std::vector<SectionPos> visible;
+    // which sections can see into which, for occlusion culling
+    VisibilityGraph visibility;
+    // level of detail each section is meshed at
+    LodSelector lods;
+    // loads and unloads chunks around the camera
+    ChunkManager streaming;
 
     Window();
 
@@ -34,6 +91,8 @@ public:
 
     void init();
 
+    void loadTextures();
+
     void destroy();
 
     void tick();
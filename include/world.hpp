@@ -0,0 +1,99 @@
+#ifndef WORLD_H
+#define WORLD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+#include "./block.hpp"
+#include "./chunk.hpp"
+#include "./chunk_map.hpp"
+#include "./config.hpp"
+
+// position of a section in section units, y counts sections up the column
+struct SectionPos {
+    int32_t x, y, z;
+
+    bool operator==(const SectionPos &other) const {
+        return this->x == other.x && this->y == other.y && this->z == other.z;
+    }
+
+    // the section touching this one across face
+    SectionPos neighbour(int face) const;
+};
+
+struct SectionPosHash {
+    size_t operator()(const SectionPos &pos) const {
+        return (uint64_t(uint32_t(pos.x)) * 0x9E3779B97F4A7C15ull)
+             ^ (uint64_t(uint32_t(pos.z)) * 0xC2B2AE3D27D4EB4Full)
+             ^ uint64_t(uint32_t(pos.y));
+    }
+};
+
+// position of a chunk column in chunk units
+struct ChunkPos {
+    int32_t x, z;
+};
+
+// chunk coordinates packed into one integer, x in the high half
+static inline uint64_t chunkKey(int32_t x, int32_t z) {
+    return uint64_t(uint32_t(x)) << 32 | uint32_t(z);
+}
+
+// calls f with the position of every section whose meshing reads the block
+// at world x, y, z: its own, plus the face, edge and corner neighbours it
+// borders on, whose corner shading looks one block across
+template <typename F>
+inline void forEachSectionTouching(int x, int y, int z, F &&f) {
+    const int local[3] = { x & 15, y & 15, z & 15 };
+    int low[3], high[3];
+    for (int axis = 0; axis < 3; axis++) {
+        low[axis] = local[axis] == 0 ? -1 : 0;
+        high[axis] = local[axis] == SECTION_SIZE - 1 ? 1 : 0;
+    }
+    for (int dy = low[1]; dy <= high[1]; dy++)
+        for (int dz = low[2]; dz <= high[2]; dz++)
+            for (int dx = low[0]; dx <= high[0]; dx++)
+                f(SectionPos{ (x >> 4) + dx, (y >> 4) + dy, (z >> 4) + dz });
+}
+
+// every loaded chunk, addressed in world block coordinates. not thread safe,
+// owned by the main thread; workers get copies of the sections they need.
+class World {
+public:
+
+    Chunk *getChunk(int32_t x, int32_t z) const;
+    // creates an empty chunk, or returns the one already loaded
+    Chunk &createChunk(int32_t x, int32_t z);
+    // takes over a chunk filled elsewhere, such as on a worker, replacing
+    // any loaded at its position
+    Chunk &addChunk(std::unique_ptr<Chunk> chunk);
+    void removeChunk(int32_t x, int32_t z);
+    size_t chunkCount() const;
+
+    // nullptr if the chunk isn't loaded or y is outside the column
+    const ChunkSection *getSection(SectionPos pos) const;
+    const LightSection *getLight(SectionPos pos) const;
+
+    // air outside loaded chunks
+    Block::BlockID getBlock(int x, int y, int z) const;
+    // ignored outside loaded chunks. marks the section dirty, and any
+    // neighbour whose faces next to the block may have changed
+    void setBlock(int x, int y, int z, Block::BlockID id);
+
+    void markDirty(SectionPos pos);
+    // marks every section of a chunk and of its eight loaded neighbours
+    // dirty, for newly filled chunks
+    void markChunkDirty(int32_t x, int32_t z);
+    // returns and clears the sections changed since the last call
+    std::vector<SectionPos> takeDirty();
+
+private:
+
+    ChunkMap<std::unique_ptr<Chunk>> chunks;
+    std::unordered_set<SectionPos, SectionPosHash> dirty;
+
+};
+
+#endif
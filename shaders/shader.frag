@@ -2,10 +2,13 @@
 out vec4 FragColor;
 
 in vec2 TexCoord;
+flat in uint Tile;
+in float Light;
 
-uniform sampler2D texture1;
-uniform vec2 texPos;
+// one layer per atlas tile, TexCoord repeats across merged quads
+uniform sampler2DArray blocks;
 
 void main() {
-	FragColor = texture(texture1, vec2((TexCoord.x + texPos.x) / 16, (TexCoord.y + texPos.y) / 16));
-}
\ No newline at end of file
+	vec4 color = texture(blocks, vec3(TexCoord, float(Tile)));
+	FragColor = vec4(color.rgb * Light, color.a);
+}
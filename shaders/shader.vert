@@ -1,12 +1,35 @@
 #version 330 core
-layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec2 aTexCoord;
+layout (location = 0) in uint aData;
 
 out vec2 TexCoord;
+flat out uint Tile;
+out float Light;
 
-uniform mat4 model, view, projection, transform;
+// shared by every program, updated once per frame
+layout (std140) uniform Frame {
+	mat4 view;
+	mat4 projection;
+	vec4 camera;
+};
 
+// section origin for every ARENA_BLOCK_VERTICES vertices of the chunk arena,
+// gl_VertexID already includes the section's base vertex
+uniform isamplerBuffer origins;
+
+// unpacks a ChunkVertex, see include/mesher.hpp for the bit layout
 void main() {
-	gl_Position = projection * view * model * transform * vec4(aPos, 1.0);
-	TexCoord = vec2(aTexCoord.x, aTexCoord.y);
-}
\ No newline at end of file
+	vec3 pos = vec3(aData & 31u, (aData >> 5) & 31u, (aData >> 10) & 31u);
+	uint axis = ((aData >> 15) & 7u) >> 1;
+
+	// side faces keep v pointing up, top and bottom map x and z
+	TexCoord = axis == 0u ? pos.zy : axis == 1u ? pos.xz : pos.xy;
+	Tile = aData >> 24;
+	// each light level a fifth dimmer than the one above, never quite
+	// black, darkened further by the corner's ambient occlusion
+	float level = float((aData >> 20) & 15u);
+	float ao = float((aData >> 18) & 3u);
+	Light = (0.05 + 0.95 * pow(0.8, 15.0 - level)) * (0.4 + 0.2 * ao);
+
+	vec3 origin = vec3(texelFetch(origins, gl_VertexID / ARENA_BLOCK_VERTICES).xyz);
+	gl_Position = projection * view * vec4(origin + pos, 1.0);
+}
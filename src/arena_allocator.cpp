@@ -0,0 +1,103 @@
+#include "../include/arena_allocator.hpp"
+
+#include <iterator>
+
+ArenaAllocator::ArenaAllocator(size_t capacity) {
+    this->total = 0;
+    this->in_use = 0;
+    this->grow(capacity);
+}
+
+size_t ArenaAllocator::allocate(size_t size) {
+    if (size == 0)
+        return NONE;
+
+    auto fit = this->by_size.lower_bound(size);
+    if (fit == this->by_size.end())
+        return NONE;
+
+    const size_t offset = fit->second;
+    const size_t range = fit->first;
+    this->removeRange(this->by_offset.find(offset));
+    // hand out the front of the range, the rest stays free
+    if (range > size)
+        this->addRange(offset + size, range - size);
+
+    this->in_use += size;
+    return offset;
+}
+
+void ArenaAllocator::free(size_t offset, size_t size) {
+    if (size == 0)
+        return;
+
+    this->in_use -= size;
+
+    // merge with the free ranges directly after and before
+    auto next = this->by_offset.lower_bound(offset);
+    if (next != this->by_offset.end() && next->first == offset + size) {
+        size += next->second;
+        this->removeRange(next);
+    }
+
+    next = this->by_offset.lower_bound(offset);
+    if (next != this->by_offset.begin()) {
+        auto prev = std::prev(next);
+        if (prev->first + prev->second == offset) {
+            offset = prev->first;
+            size += prev->second;
+            this->removeRange(prev);
+        }
+    }
+
+    this->addRange(offset, size);
+}
+
+void ArenaAllocator::grow(size_t capacity) {
+    if (capacity <= this->total)
+        return;
+    const size_t added = capacity - this->total;
+    const size_t offset = this->total;
+    this->total = capacity;
+    // counted as in use for the moment so free() can merge it normally
+    this->in_use += added;
+    this->free(offset, added);
+}
+
+size_t ArenaAllocator::capacity() const {
+    return this->total;
+}
+
+size_t ArenaAllocator::used() const {
+    return this->in_use;
+}
+
+size_t ArenaAllocator::largestFree() const {
+    return this->by_size.empty() ? 0 : this->by_size.rbegin()->first;
+}
+
+size_t ArenaAllocator::freeRanges() const {
+    return this->by_offset.size();
+}
+
+float ArenaAllocator::fragmentation() const {
+    const size_t free = this->total - this->in_use;
+    return free == 0 ? 0.0f : 1.0f - float(this->largestFree()) / float(free);
+}
+
+/* -------------------------------------------------------------------------- */
+void ArenaAllocator::addRange(size_t offset, size_t size) {
+    this->by_offset[offset] = size;
+    this->by_size.insert({ size, offset });
+}
+
+void ArenaAllocator::removeRange(std::map<size_t, size_t>::iterator it) {
+    auto range = this->by_size.equal_range(it->second);
+    for (auto s = range.first; s != range.second; ++s) {
+        if (s->second == it->first) {
+            this->by_size.erase(s);
+            break;
+        }
+    }
+    this->by_offset.erase(it);
+}
@@ -1,5 +0,0 @@
-#include "../include/block.hpp"
-
-void Block::block_init() {
-
-}
\ No newline at end of file
@@ -0,0 +1,48 @@
+#include "../include/camera.hpp"
+
+#include <cmath>
+
+Camera::Camera(glm::vec3 position) {
+    this->position = position;
+    this->up = glm::vec3(0.0f, 1.0f, 0.0f);
+    this->yaw = -90.0f;
+    this->pitch = 0.0f;
+    this->fov = 45.0f;
+    this->look(0.0f, 0.0f);
+}
+
+glm::mat4 Camera::view() const {
+    return glm::lookAt(this->position, this->position + this->front, this->up);
+}
+
+glm::mat4 Camera::projection(float aspect) const {
+    // arg1, sets FOV
+    // arg2, aspect ratio
+    // arg3, near plane of frustum
+    // arg4, far plane of frustum
+    return glm::perspective(glm::radians(this->fov), aspect, 0.1f, 1000.0f);
+}
+
+void Camera::look(float xoffset, float yoffset) {
+    const float sensitivity = 0.07f;
+
+    this->yaw += xoffset * sensitivity;
+    this->pitch += yoffset * sensitivity;
+
+    if (this->pitch > 89.0f) this->pitch = 89.0f;
+    if (this->pitch < -89.0f) this->pitch = -89.0f;
+
+    glm::vec3 direction;
+    direction.x = cos(glm::radians(this->yaw)) * cos(glm::radians(this->pitch));
+    direction.y = sin(glm::radians(this->pitch));
+    direction.z = sin(glm::radians(this->yaw)) * cos(glm::radians(this->pitch));
+    this->front = glm::normalize(direction);
+}
+
+void Camera::zoom(float yoffset) {
+    this->fov -= yoffset;
+    if (this->fov < 1.0f)
+        this->fov = 1.0f;
+    if (this->fov > 45.0f)
+        this->fov = 45.0f;
+}
@@ -0,0 +1,331 @@
+#include "../include/chunk.hpp"
+
+#include <algorithm>
+
+/* -------------------------------------------------------------------------- */
+// number of palette slots addressable with the given index width
+static inline int slotCapacity(int bits) {
+    return bits == 0 ? 1 : 1 << bits;
+}
+
+// smallest supported index width able to address n palette slots. widths are
+// kept to divisors of 64 so a packed index never straddles two words.
+static inline uint8_t bitsFor(int n) {
+    if (n <= 1)   return 0;
+    if (n <= 2)   return 1;
+    if (n <= 4)   return 2;
+    if (n <= 16)  return 4;
+    if (n <= 256) return 8;
+    return 16;
+}
+
+// next narrower index width, used to decide when a palette should shrink
+static inline uint8_t narrowerBits(int bits) {
+    return bits == 16 ? 8 : bits == 8 ? 4 : bits == 4 ? 2 : bits == 2 ? 1 : 0;
+}
+
+/* -------------------------------------------------------------------------- */
+ChunkSection::ChunkSection(Block::BlockID fill) {
+    this->bits = 0;
+    this->live = 0;
+    this->fill(fill);
+}
+
+Block::BlockID ChunkSection::get(int x, int y, int z) const {
+    return this->get(index(x, y, z));
+}
+
+Block::BlockID ChunkSection::get(int index) const {
+    return this->palette[this->readSlot(index)];
+}
+
+void ChunkSection::set(int x, int y, int z, Block::BlockID id) {
+    this->set(index(x, y, z), id);
+}
+
+void ChunkSection::set(int index, Block::BlockID id) {
+    int old_slot = this->readSlot(index);
+    if (this->palette[old_slot] == id)
+        return;
+
+    int slot = this->findSlot(id);
+    if (slot < 0) {
+        slot = this->addSlot(id);
+        // growing the palette may have repacked and renumbered the slots
+        old_slot = this->readSlot(index);
+    }
+
+    this->writeSlot(index, slot);
+    this->refcount[slot]++;
+
+    if (--this->refcount[old_slot] == 0)
+        this->releaseSlot(old_slot);
+}
+
+void ChunkSection::fill(Block::BlockID id) {
+    this->palette.assign(1, id);
+    this->refcount.assign(1, SECTION_VOLUME);
+    this->words.clear();
+    this->words.shrink_to_fit();
+    this->bits = 0;
+    this->live = 1;
+}
+
+void ChunkSection::assign(const Block::BlockID *blocks) {
+    std::vector<Block::BlockID> new_palette;
+    std::vector<uint16_t> new_refcount;
+    std::vector<uint16_t> slots(SECTION_VOLUME);
+
+    // neighbouring blocks are usually the same type, so remember the last hit
+    // before falling back to a scan of the (small) palette
+    Block::BlockID last_id = blocks[0];
+    int last_slot = 0;
+    new_palette.push_back(last_id);
+    new_refcount.push_back(0);
+
+    for (int i = 0; i < SECTION_VOLUME; i++) {
+        if (blocks[i] != last_id) {
+            last_id = blocks[i];
+            auto it = std::find(new_palette.begin(), new_palette.end(), last_id);
+            last_slot = it - new_palette.begin();
+            if (it == new_palette.end()) {
+                new_palette.push_back(last_id);
+                new_refcount.push_back(0);
+            }
+        }
+        slots[i] = last_slot;
+        new_refcount[last_slot]++;
+    }
+
+    if (new_palette.size() == 1) {
+        this->fill(new_palette[0]);
+        return;
+    }
+
+    this->palette.swap(new_palette);
+    this->refcount.swap(new_refcount);
+    this->live = this->palette.size();
+    this->bits = bitsFor(this->live);
+    this->words.assign(SECTION_VOLUME * this->bits / 64, 0);
+    this->words.shrink_to_fit();
+
+    for (int i = 0; i < SECTION_VOLUME; i++)
+        this->writeSlot(i, slots[i]);
+}
+
+void ChunkSection::unpack(Block::BlockID *out) const {
+    if (this->bits == 0) {
+        std::fill(out, out + SECTION_VOLUME, this->palette[0]);
+        return;
+    }
+
+    // decode a whole word at a time rather than recomputing offsets per block
+    const int per_word = 64 / this->bits;
+    const uint64_t mask = (uint64_t(1) << this->bits) - 1;
+    const Block::BlockID *palette = this->palette.data();
+
+    for (size_t w = 0; w < this->words.size(); w++) {
+        uint64_t word = this->words[w];
+        for (int i = 0; i < per_word; i++) {
+            *out++ = palette[word & mask];
+            word >>= this->bits;
+        }
+    }
+}
+
+bool ChunkSection::isUniform() const {
+    return this->bits == 0;
+}
+
+bool ChunkSection::isEmpty() const {
+    return this->bits == 0 && this->palette[0] == Block::AIR;
+}
+
+int ChunkSection::paletteSize() const {
+    return this->live;
+}
+
+int ChunkSection::bitsPerBlock() const {
+    return this->bits;
+}
+
+size_t ChunkSection::memoryUsage() const {
+    return sizeof(ChunkSection)
+         + this->palette.capacity() * sizeof(Block::BlockID)
+         + this->refcount.capacity() * sizeof(uint16_t)
+         + this->words.capacity() * sizeof(uint64_t);
+}
+
+/* -------------------------------------------------------------------------- */
+// reads the palette slot stored for a block
+int ChunkSection::readSlot(int index) const {
+    if (this->bits == 0)
+        return 0;
+
+    const int bit = index * this->bits;
+    const uint64_t mask = (uint64_t(1) << this->bits) - 1;
+    return (this->words[bit >> 6] >> (bit & 63)) & mask;
+}
+
+// stores the palette slot for a block, the section must not be uniform
+void ChunkSection::writeSlot(int index, int slot) {
+    const int bit = index * this->bits;
+    const uint64_t mask = (uint64_t(1) << this->bits) - 1;
+    uint64_t &word = this->words[bit >> 6];
+    word = (word & ~(mask << (bit & 63))) | (uint64_t(slot) << (bit & 63));
+}
+
+// returns the live slot holding id, or -1 if id is not in the palette
+int ChunkSection::findSlot(Block::BlockID id) const {
+    for (size_t i = 0; i < this->palette.size(); i++) {
+        if (this->palette[i] == id && this->refcount[i] != 0)
+            return i;
+    }
+    return -1;
+}
+
+// claims a slot for id, reusing a freed slot or widening the index array
+int ChunkSection::addSlot(Block::BlockID id) {
+    this->live++;
+
+    for (size_t i = 0; i < this->palette.size(); i++) {
+        if (this->refcount[i] == 0) {
+            this->palette[i] = id;
+            return i;
+        }
+    }
+
+    if ((int)this->palette.size() == slotCapacity(this->bits))
+        this->repack(bitsFor(this->live));
+
+    this->palette.push_back(id);
+    this->refcount.push_back(0);
+    return this->palette.size() - 1;
+}
+
+// called once the last block using slot is overwritten
+void ChunkSection::releaseSlot(int slot) {
+    this->live--;
+
+    // a free slot at the end of the palette, and any free ones before it,
+    // are dropped rather than kept for reuse, so the palette shrinks back
+    // towards the live slots and lookups scan fewer of them
+    if (slot == (int)this->palette.size() - 1) {
+        while (!this->refcount.empty() && this->refcount.back() == 0) {
+            this->palette.pop_back();
+            this->refcount.pop_back();
+        }
+    }
+
+    if (this->live == 1) {
+        // a single block type is left, drop the index array entirely
+        for (size_t i = 0; i < this->palette.size(); i++) {
+            if (this->refcount[i] != 0) {
+                this->fill(this->palette[i]);
+                return;
+            }
+        }
+    }
+
+    // only narrow once the palette would sit at most half full at the smaller
+    // width, so a block toggled back and forth at a size boundary doesn't
+    // repack the section on every edit
+    const int narrower = narrowerBits(this->bits);
+    if (narrower != 0 && this->live * 2 <= slotCapacity(narrower))
+        this->repack(bitsFor(this->live));
+}
+
+void ChunkSection::repack(uint8_t new_bits) {
+    std::vector<int> remap(this->palette.size(), -1);
+    std::vector<Block::BlockID> new_palette;
+    std::vector<uint16_t> new_refcount;
+
+    for (size_t i = 0; i < this->palette.size(); i++) {
+        if (this->refcount[i] != 0) {
+            remap[i] = new_palette.size();
+            new_palette.push_back(this->palette[i]);
+            new_refcount.push_back(this->refcount[i]);
+        }
+    }
+
+    std::vector<uint64_t> new_words(SECTION_VOLUME * new_bits / 64, 0);
+    for (int i = 0; i < SECTION_VOLUME; i++) {
+        const int bit = i * new_bits;
+        new_words[bit >> 6] |= uint64_t(remap[this->readSlot(i)]) << (bit & 63);
+    }
+
+    this->palette.swap(new_palette);
+    this->refcount.swap(new_refcount);
+    this->words.swap(new_words);
+    this->bits = new_bits;
+}
+
+/* -------------------------------------------------------------------------- */
+NibbleArray::NibbleArray(uint8_t fill) {
+    this->uniform = fill;
+}
+
+void NibbleArray::set(int index, uint8_t value) {
+    if (this->nibbles.empty()) {
+        if (value == this->uniform)
+            return;
+        this->nibbles.assign(SECTION_VOLUME / 2, this->uniform * 0x11);
+    }
+
+    uint8_t &byte = this->nibbles[index >> 1];
+    const int shift = (index & 1) << 2;
+    byte = (byte & ~(15 << shift)) | (value << shift);
+}
+
+void NibbleArray::fill(uint8_t value) {
+    this->nibbles.clear();
+    this->nibbles.shrink_to_fit();
+    this->uniform = value;
+}
+
+void NibbleArray::compact() {
+    if (this->nibbles.empty())
+        return;
+
+    const uint8_t first = this->nibbles[0];
+    if ((first >> 4) != (first & 15))
+        return;
+    for (uint8_t byte : this->nibbles) {
+        if (byte != first)
+            return;
+    }
+    this->fill(first & 15);
+}
+
+bool NibbleArray::isUniform() const {
+    return this->nibbles.empty();
+}
+
+size_t NibbleArray::memoryUsage() const {
+    return sizeof(NibbleArray) + this->nibbles.capacity();
+}
+
+size_t LightSection::memoryUsage() const {
+    return this->sky.memoryUsage() + this->block.memoryUsage();
+}
+
+/* -------------------------------------------------------------------------- */
+Chunk::Chunk(int32_t x, int32_t z) {
+    this->x = x;
+    this->z = z;
+}
+
+Block::BlockID Chunk::get(int x, int y, int z) const {
+    return this->sections[y / SECTION_SIZE].get(x, y % SECTION_SIZE, z);
+}
+
+void Chunk::set(int x, int y, int z, Block::BlockID id) {
+    this->sections[y / SECTION_SIZE].set(x, y % SECTION_SIZE, z, id);
+}
+
+size_t Chunk::memoryUsage() const {
+    size_t total = sizeof(Chunk) - sizeof(this->sections) - sizeof(this->light);
+    for (int i = 0; i < CHUNK_SECTIONS; i++)
+        total += this->sections[i].memoryUsage() + this->light[i].memoryUsage();
+    return total;
+}
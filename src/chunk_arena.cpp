@@ -0,0 +1,200 @@
+#include "../include/chunk_arena.hpp"
+#include "../include/profiler.hpp"
+
+#include <algorithm>
+
+// copies the first bytes of src into a new buffer of new_bytes, deleting src
+static unsigned int resizeBuffer(unsigned int src, size_t bytes, size_t new_bytes) {
+    unsigned int dst;
+    glGenBuffers(1, &dst);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, dst);
+    glBufferData(GL_COPY_WRITE_BUFFER, new_bytes, NULL, GL_DYNAMIC_DRAW);
+
+    if (src != 0) {
+        glBindBuffer(GL_COPY_READ_BUFFER, src);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, bytes);
+        glDeleteBuffers(1, &src);
+    }
+    return dst;
+}
+
+/* -------------------------------------------------------------------------- */
+ChunkArena::ChunkArena() {
+    this->VAO = this->VBO = this->EBO = 0;
+    this->origin_buffer = this->origin_texture = 0;
+}
+
+void ChunkArena::create(size_t vertex_capacity, size_t index_capacity) {
+    this->destroy();
+
+    glGenVertexArrays(1, &this->VAO);
+    glGenTextures(1, &this->origin_texture);
+
+    this->growVertices((vertex_capacity + ARENA_BLOCK_VERTICES - 1) / ARENA_BLOCK_VERTICES);
+    this->growIndices(index_capacity);
+}
+
+void ChunkArena::upload(SectionPos pos, const ChunkMesh &mesh) {
+    this->remove(pos);
+    if (mesh.indices.empty())
+        return;
+
+    ArenaSlot slot;
+    slot.vertex_blocks = (mesh.vertices.size() + ARENA_BLOCK_VERTICES - 1) / ARENA_BLOCK_VERTICES;
+    slot.index_count = mesh.indices.size();
+
+    slot.vertex_block = this->vertex_space.allocate(slot.vertex_blocks);
+    if (slot.vertex_block == ArenaAllocator::NONE) {
+        this->growVertices(std::max(this->vertex_space.capacity() * 2,
+                                    this->vertex_space.capacity() + slot.vertex_blocks));
+        slot.vertex_block = this->vertex_space.allocate(slot.vertex_blocks);
+    }
+    slot.index_offset = this->index_space.allocate(slot.index_count);
+    if (slot.index_offset == ArenaAllocator::NONE) {
+        this->growIndices(std::max(this->index_space.capacity() * 2,
+                                   this->index_space.capacity() + slot.index_count));
+        slot.index_offset = this->index_space.allocate(slot.index_count);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, this->VBO);
+    glBufferSubData(GL_ARRAY_BUFFER, slot.vertex_block * ARENA_BLOCK_VERTICES * sizeof(ChunkVertex),
+                    mesh.vertices.size() * sizeof(ChunkVertex), mesh.vertices.data());
+
+    // the element buffer is VAO state, bind it outside the VAO through
+    // another target so the VAO keeps pointing at the arena
+    glBindBuffer(GL_COPY_WRITE_BUFFER, this->EBO);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, slot.index_offset * sizeof(uint32_t),
+                    mesh.indices.size() * sizeof(uint32_t), mesh.indices.data());
+
+    // every block of the section's vertices maps to the section's origin
+    std::vector<GLint> origins(slot.vertex_blocks * 4);
+    for (size_t i = 0; i < slot.vertex_blocks; i++) {
+        origins[i * 4 + 0] = pos.x * SECTION_SIZE;
+        origins[i * 4 + 1] = pos.y * SECTION_SIZE;
+        origins[i * 4 + 2] = pos.z * SECTION_SIZE;
+        origins[i * 4 + 3] = 0;
+    }
+    glBindBuffer(GL_TEXTURE_BUFFER, this->origin_buffer);
+    glBufferSubData(GL_TEXTURE_BUFFER, slot.vertex_block * 4 * sizeof(GLint),
+                    origins.size() * sizeof(GLint), origins.data());
+
+    this->slots[pos] = slot;
+}
+
+void ChunkArena::remove(SectionPos pos) {
+    auto it = this->slots.find(pos);
+    if (it == this->slots.end())
+        return;
+
+    this->vertex_space.free(it->second.vertex_block, it->second.vertex_blocks);
+    this->index_space.free(it->second.index_offset, it->second.index_count);
+    this->slots.erase(it);
+}
+
+size_t ChunkArena::draw(const std::vector<SectionPos> &sections) {
+    this->counts.clear();
+    this->offsets.clear();
+    this->base_vertices.clear();
+
+    for (const SectionPos &pos : sections) {
+        auto it = this->slots.find(pos);
+        if (it == this->slots.end())
+            continue;
+        const ArenaSlot &slot = it->second;
+        this->counts.push_back(slot.index_count);
+        this->offsets.push_back((const void *)(slot.index_offset * sizeof(uint32_t)));
+        this->base_vertices.push_back(slot.vertex_block * ARENA_BLOCK_VERTICES);
+    }
+
+    if (this->counts.empty())
+        return 0;
+
+    glBindVertexArray(this->VAO);
+    glMultiDrawElementsBaseVertex(GL_TRIANGLES, this->counts.data(), GL_UNSIGNED_INT,
+                                  (const void *const *)this->offsets.data(),
+                                  this->counts.size(), this->base_vertices.data());
+    return 1;
+}
+
+void ChunkArena::bindOrigins(unsigned int unit) const {
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(GL_TEXTURE_BUFFER, this->origin_texture);
+}
+
+size_t ChunkArena::sectionCount() const {
+    return this->slots.size();
+}
+
+const ArenaAllocator &ChunkArena::vertexSpace() const {
+    return this->vertex_space;
+}
+
+const ArenaAllocator &ChunkArena::indexSpace() const {
+    return this->index_space;
+}
+
+void ChunkArena::destroy() {
+    if (this->VAO == 0)
+        return;
+
+    glDeleteVertexArrays(1, &this->VAO);
+    glDeleteBuffers(1, &this->VBO);
+    glDeleteBuffers(1, &this->EBO);
+    glDeleteBuffers(1, &this->origin_buffer);
+    glDeleteTextures(1, &this->origin_texture);
+    this->VAO = this->VBO = this->EBO = 0;
+    this->origin_buffer = this->origin_texture = 0;
+
+    this->vertex_space = ArenaAllocator();
+    this->index_space = ArenaAllocator();
+    this->slots.clear();
+}
+
+/* -------------------------------------------------------------------------- */
+// enlarges the vertex buffer and its origin lookup to hold blocks blocks,
+// keeping every section where it is
+void ChunkArena::growVertices(size_t blocks) {
+    PROFILE_ZONE("arena grow");
+
+    const size_t old_blocks = this->vertex_space.capacity();
+    this->VBO = resizeBuffer(this->VBO, old_blocks * ARENA_BLOCK_VERTICES * sizeof(ChunkVertex),
+                             blocks * ARENA_BLOCK_VERTICES * sizeof(ChunkVertex));
+    this->origin_buffer = resizeBuffer(this->origin_buffer, old_blocks * 4 * sizeof(GLint),
+                                       blocks * 4 * sizeof(GLint));
+    this->vertex_space.grow(blocks);
+
+    glBindTexture(GL_TEXTURE_BUFFER, this->origin_texture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32I, this->origin_buffer);
+
+    this->bindVertexLayout();
+}
+
+void ChunkArena::growIndices(size_t indices) {
+    PROFILE_ZONE("arena grow");
+
+    this->EBO = resizeBuffer(this->EBO, this->index_space.capacity() * sizeof(uint32_t),
+                             indices * sizeof(uint32_t));
+    this->index_space.grow(indices);
+
+    this->bindVertexLayout();
+}
+
+// points the VAO at the current buffers
+void ChunkArena::bindVertexLayout() {
+    glBindVertexArray(this->VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, this->VBO);
+    if (this->EBO != 0)
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->EBO);
+
+    // the whole vertex is one packed integer, unpacked in the vertex
+    // shader. the I variant keeps it from being converted to float.
+    glVertexAttribIPointer(
+        0,                      // specify which vertex attribute (location 0)
+        1,                      // size of vertex attribute (one uint)
+        GL_UNSIGNED_INT,        // type of data
+        sizeof(ChunkVertex),    // the stride (how long is one vertex in memory)
+        (void *)0               // the offset (where to start reading)
+    );
+    glEnableVertexAttribArray(0);
+    glBindVertexArray(0);
+}
@@ -0,0 +1,315 @@
+#include "../include/chunk_manager.hpp"
+#include "../include/clock.hpp"
+#include "../include/profiler.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+// how much further a chunk directly behind the camera counts as than one
+// straight ahead, on top of its distance
+static const float VIEW_WEIGHT = 2.0f;
+// the heap is reordered once the camera turns further than this, as the
+// cosine of the angle turned
+static const float RESORT_COS = 0.866f;
+
+static const int NEIGHBOURS[8][2] = {
+    { -1, -1 }, { 0, -1 }, { 1, -1 }, { -1, 0 }, { 1, 0 }, { -1, 1 }, { 0, 1 }, { 1, 1 }
+};
+
+/* -------------------------------------------------------------------------- */
+ChunkManager::ChunkManager(World &world, LightEngine &light, const TerrainGenerator &terrain, JobSystem &jobs,
+                           int radius) : world(world), light(light), terrain(terrain), jobs(jobs) {
+    this->radius = radius;
+    this->finished = std::make_shared<MpscQueue<Generated>>();
+    this->in_flight = 0;
+    this->generating_count = 0;
+    this->lit_count = this->ready_count = 0;
+    this->next_version = 0;
+    this->light_ns_per_chunk = 0.0;
+    this->x = this->y = this->z = 0.0f;
+    this->dir_x = this->dir_z = 0.0f;
+    this->camera_x = this->camera_z = 0;
+    this->sorted_dir_x = this->sorted_dir_z = 0.0f;
+    this->scanned = false;
+}
+
+void ChunkManager::update(float x, float y, float z, float dir_x, float dir_z, std::vector<ChunkPos> &unloaded) {
+    PROFILE_ZONE("streaming");
+
+    this->x = x;
+    this->y = y;
+    this->z = z;
+    const float length = std::sqrt(dir_x * dir_x + dir_z * dir_z);
+    this->dir_x = length > 1e-4f ? dir_x / length : 0.0f;
+    this->dir_z = length > 1e-4f ? dir_z / length : 0.0f;
+
+    const int32_t camera_x = int32_t(std::floor(x / SECTION_SIZE));
+    const int32_t camera_z = int32_t(std::floor(z / SECTION_SIZE));
+    if (!this->scanned || camera_x != this->camera_x || camera_z != this->camera_z) {
+        this->camera_x = camera_x;
+        this->camera_z = camera_z;
+        this->scanned = true;
+        this->scan(unloaded);
+        this->reprioritize();
+    } else if (this->dir_x * this->sorted_dir_x + this->dir_z * this->sorted_dir_z < RESORT_COS) {
+        this->reprioritize();
+    }
+
+    this->receive();
+    this->startGeneration();
+    this->lightBatches();
+}
+
+std::vector<SectionPos> ChunkManager::takeDirty() {
+    std::vector<std::pair<float, SectionPos>> ordered;
+    for (const SectionPos &pos : this->world.takeDirty()) {
+        if (!this->ready(pos.x, pos.z))
+            continue;
+        // sections far above or below the camera after those level with it
+        const float height = std::fabs((pos.y + 0.5f) * SECTION_SIZE - this->y) / SECTION_SIZE;
+        ordered.emplace_back(this->priority(pos.x, pos.z) + height, pos);
+    }
+    std::sort(ordered.begin(), ordered.end(), [](const std::pair<float, SectionPos> &a,
+                                                 const std::pair<float, SectionPos> &b) {
+        return a.first < b.first;
+    });
+
+    std::vector<SectionPos> sections;
+    sections.reserve(ordered.size());
+    for (const auto &entry : ordered)
+        sections.push_back(entry.second);
+    return sections;
+}
+
+float ChunkManager::priority(int32_t x, int32_t z) const {
+    const float dx = ((x + 0.5f) * SECTION_SIZE - this->x) / SECTION_SIZE;
+    const float dz = ((z + 0.5f) * SECTION_SIZE - this->z) / SECTION_SIZE;
+    const float distance = std::sqrt(dx * dx + dz * dz);
+    if (distance < 1e-4f)
+        return 0.0f;
+    // cosine of the angle between the view and the chunk, 1 straight ahead
+    const float facing = (dx * this->dir_x + dz * this->dir_z) / distance;
+    return distance * (1.0f + VIEW_WEIGHT * 0.5f * (1.0f - facing));
+}
+
+bool ChunkManager::ready(int32_t x, int32_t z) const {
+    const Entry *entry = this->find(x, z);
+    return entry && entry->ready;
+}
+
+size_t ChunkManager::queued() const {
+    return this->entries.size() - this->generating_count - this->loaded();
+}
+
+size_t ChunkManager::generating() const {
+    return this->generating_count;
+}
+
+size_t ChunkManager::loaded() const {
+    return this->unlit.size() + this->lit_count;
+}
+
+size_t ChunkManager::readyCount() const {
+    return this->ready_count;
+}
+
+/* -------------------------------------------------------------------------- */
+const ChunkManager::Entry *ChunkManager::find(int32_t x, int32_t z) const {
+    auto it = this->entries.find(chunkKey(x, z));
+    return it == this->entries.end() ? nullptr : &it->second;
+}
+
+bool ChunkManager::inRange(int32_t x, int32_t z, int range) const {
+    const int64_t dx = x - this->camera_x, dz = z - this->camera_z;
+    return dx * dx + dz * dz <= int64_t(range) * range;
+}
+
+void ChunkManager::scan(std::vector<ChunkPos> &unloaded) {
+    for (int dz = -this->radius; dz <= this->radius; dz++) {
+        for (int dx = -this->radius; dx <= this->radius; dx++) {
+            const int32_t cx = this->camera_x + dx, cz = this->camera_z + dz;
+            if (!this->inRange(cx, cz, this->radius))
+                continue;
+            const uint64_t key = chunkKey(cx, cz);
+            if (this->entries.count(key))
+                continue;
+            this->entries[key] = { cx, cz, QUEUED, false, 0 };
+        }
+    }
+
+    for (auto it = this->entries.begin(); it != this->entries.end();) {
+        Entry &entry = it->second;
+        // unstarted or unfinished work is dropped as soon as it leaves the
+        // load radius, a generation job still running is left to finish
+        // and its chunk thrown away
+        if (entry.stage <= GENERATING && !this->inRange(entry.x, entry.z, this->radius)) {
+            if (entry.stage == GENERATING)
+                this->generating_count--;
+            it = this->entries.erase(it);
+            continue;
+        }
+        if (entry.stage >= GENERATED && !this->inRange(entry.x, entry.z, this->radius + UNLOAD_HYSTERESIS)) {
+            this->world.removeChunk(entry.x, entry.z);
+            unloaded.push_back({ entry.x, entry.z });
+            this->unlit.erase(it->first);
+            this->unready.erase(it->first);
+            if (entry.stage == LIT)
+                this->lit_count--;
+            if (entry.ready)
+                this->ready_count--;
+            it = this->entries.erase(it);
+            continue;
+        }
+        ++it;
+    }
+}
+
+void ChunkManager::reprioritize() {
+    this->sorted_dir_x = this->dir_x;
+    this->sorted_dir_z = this->dir_z;
+
+    this->heap.clear();
+    for (const auto &it : this->entries) {
+        const Entry &entry = it.second;
+        if (entry.stage == QUEUED)
+            this->heap.push_back({ this->priority(entry.x, entry.z), entry.x, entry.z });
+    }
+    std::make_heap(this->heap.begin(), this->heap.end());
+}
+
+void ChunkManager::receive() {
+    Generated result;
+    while (this->finished->pop(result)) {
+        this->in_flight--;
+
+        // stale if the chunk left range, even if it came back since
+        auto it = this->entries.find(chunkKey(result.chunk->x, result.chunk->z));
+        if (it == this->entries.end() || it->second.stage != GENERATING || it->second.version != result.version)
+            continue;
+
+        this->world.addChunk(std::move(result.chunk));
+        it->second.stage = GENERATED;
+        this->generating_count--;
+        this->unlit.insert(it->first);
+    }
+}
+
+void ChunkManager::startGeneration() {
+    // few enough in flight that a turn or a teleport reorders most of the
+    // work, enough to keep every worker busy
+    const size_t limit = 2 * std::max(1u, this->jobs.threadCount());
+
+    while (this->in_flight < limit && !this->heap.empty()) {
+        std::pop_heap(this->heap.begin(), this->heap.end());
+        const Candidate next = this->heap.back();
+        this->heap.pop_back();
+
+        auto it = this->entries.find(chunkKey(next.x, next.z));
+        if (it == this->entries.end() || it->second.stage != QUEUED)
+            continue;
+        it->second.stage = GENERATING;
+        it->second.version = ++this->next_version;
+        this->in_flight++;
+        this->generating_count++;
+
+        std::shared_ptr<MpscQueue<Generated>> finished = this->finished;
+        const TerrainGenerator terrain = this->terrain;
+        const uint32_t version = it->second.version;
+        const int32_t cx = next.x, cz = next.z;
+        this->jobs.submit([finished, terrain, version, cx, cz] {
+            PROFILE_ZONE("generate");
+
+            Generated result;
+            result.chunk.reset(new Chunk(cx, cz));
+            result.version = version;
+            terrain.generate(*result.chunk);
+            finished->push(std::move(result));
+        });
+    }
+}
+
+void ChunkManager::lightBatches() {
+    const uint64_t start = monotonicNs();
+    // the workers plus this thread
+    const size_t lanes = this->jobs.threadCount() + 1;
+
+    std::vector<Candidate> candidates;
+    std::vector<ChunkPos> batch;
+    bool lit_any = false;
+    for (;;) {
+        const uint64_t elapsed = monotonicNs() - start;
+        if (this->unlit.empty() || elapsed >= LIGHT_BUDGET_NS)
+            break;
+        // a single chunk to time until there is an estimate, and always
+        // one a frame so lighting never stalls
+        size_t batch_size = 1;
+        if (this->light_ns_per_chunk > 0.0)
+            batch_size = std::min(lanes, size_t((LIGHT_BUDGET_NS - elapsed) / this->light_ns_per_chunk));
+        if (batch_size == 0 && lit_any)
+            break;
+        batch_size = std::max<size_t>(batch_size, 1);
+
+        // light reaches a chunk's neighbours, so they need their blocks
+        // first. neighbours out of range are never coming
+        candidates.clear();
+        for (uint64_t key : this->unlit) {
+            const Entry &entry = this->entries[key];
+            bool waiting = false;
+            for (const auto &offset : NEIGHBOURS) {
+                const Entry *neighbour = this->find(entry.x + offset[0], entry.z + offset[1]);
+                waiting |= neighbour && neighbour->stage < GENERATED;
+            }
+            if (!waiting)
+                candidates.push_back({ this->priority(entry.x, entry.z), entry.x, entry.z });
+        }
+        if (candidates.empty())
+            break;
+
+        const size_t count = std::min(batch_size, candidates.size());
+        std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(),
+                          [](const Candidate &a, const Candidate &b) { return a.priority < b.priority; });
+        batch.clear();
+        for (size_t i = 0; i < count; i++)
+            batch.push_back({ candidates[i].x, candidates[i].z });
+
+        const uint64_t batch_start = monotonicNs();
+        this->light.lightChunks(batch, this->jobs);
+        const double per_chunk = double(monotonicNs() - batch_start) / count;
+        this->light_ns_per_chunk = this->light_ns_per_chunk > 0.0
+                                 ? 0.75 * this->light_ns_per_chunk + 0.25 * per_chunk
+                                 : per_chunk;
+        lit_any = true;
+
+        for (const ChunkPos &pos : batch) {
+            const uint64_t key = chunkKey(pos.x, pos.z);
+            this->entries[key].stage = LIT;
+            this->unlit.erase(key);
+            this->unready.insert(key);
+            this->lit_count++;
+            // the chunk's own sections and its neighbours' bordering ones
+            // see its blocks and light for the first time
+            this->world.markChunkDirty(pos.x, pos.z);
+        }
+        PROFILE_COUNT("chunks lit", batch.size());
+    }
+
+    // a neighbour lighting or leaving range can both let a chunk mesh
+    for (auto it = this->unready.begin(); it != this->unready.end();) {
+        Entry &entry = this->entries[*it];
+        bool waiting = false;
+        for (const auto &offset : NEIGHBOURS) {
+            const Entry *neighbour = this->find(entry.x + offset[0], entry.z + offset[1]);
+            waiting |= neighbour && neighbour->stage != LIT;
+        }
+        if (waiting) {
+            ++it;
+            continue;
+        }
+
+        entry.ready = true;
+        this->ready_count++;
+        for (int y = 0; y < CHUNK_SECTIONS; y++)
+            this->world.markDirty({ entry.x, y, entry.z });
+        it = this->unready.erase(it);
+    }
+}
@@ -0,0 +1,52 @@
+#include "../include/fixed_timestep.hpp"
+
+#include <algorithm>
+
+FixedTimestep::FixedTimestep(uint32_t tps, uint32_t max_ticks) {
+    this->max_ticks = max_ticks;
+    this->setRate(tps);
+    this->reset(0);
+}
+
+void FixedTimestep::reset(uint64_t now_ns) {
+    this->last_ns = now_ns;
+    this->remainder = 0;
+    this->dropped = 0;
+}
+
+uint32_t FixedTimestep::advance(uint64_t now_ns) {
+    this->remainder += now_ns - this->last_ns;
+    this->last_ns = now_ns;
+
+    uint64_t due = this->remainder / this->tick_ns;
+    this->remainder -= due * this->tick_ns;
+
+    if (due > this->max_ticks) {
+        this->dropped += (due - this->max_ticks) * this->tick_ns;
+        due = this->max_ticks;
+    }
+    return due;
+}
+
+float FixedTimestep::alpha() const {
+    return (float)this->remainder / (float)this->tick_ns;
+}
+
+void FixedTimestep::setRate(uint32_t tps) {
+    // at least one tick a second and at most one a nanosecond, so tick_ns
+    // is never 0 for advance() and alpha() to divide by
+    this->tps = std::min(std::max(tps, 1u), 1000000000u);
+    this->tick_ns = 1000000000ull / this->tps;
+}
+
+uint32_t FixedTimestep::rate() const {
+    return this->tps;
+}
+
+uint64_t FixedTimestep::tickNs() const {
+    return this->tick_ns;
+}
+
+uint64_t FixedTimestep::droppedNs() const {
+    return this->dropped;
+}
@@ -0,0 +1,304 @@
+#include "../include/frustum.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define FRUSTUM_SSE 1
+#endif
+
+/* -------------------------------------------------------------------------- */
+Frustum::Frustum() {
+    for (int p = 0; p < PLANE_COUNT; p++) {
+        this->planes[p][0] = 0.0f;
+        this->planes[p][1] = 0.0f;
+        this->planes[p][2] = 0.0f;
+        this->planes[p][3] = 1.0f;
+    }
+}
+
+Frustum::Frustum(const float *clip) {
+    // row i of the matrix is clip[i], clip[4 + i], clip[8 + i], clip[12 + i].
+    // each plane is the last row plus or minus one of the first three
+    for (int p = 0; p < PLANE_COUNT; p++) {
+        const int row = p >> 1;
+        const float sign = (p & 1) ? -1.0f : 1.0f;
+        for (int i = 0; i < 4; i++)
+            this->planes[p][i] = clip[i * 4 + 3] + sign * clip[i * 4 + row];
+
+        // normalized so the plane equation gives real distances
+        const float length = std::sqrt(this->planes[p][0] * this->planes[p][0]
+                                     + this->planes[p][1] * this->planes[p][1]
+                                     + this->planes[p][2] * this->planes[p][2]);
+        if (length > 0.0f) {
+            for (int i = 0; i < 4; i++)
+                this->planes[p][i] /= length;
+        }
+    }
+}
+
+bool Frustum::testBox(const float min[3], const float max[3]) const {
+    for (int p = 0; p < PLANE_COUNT; p++) {
+        const float *plane = this->planes[p];
+        // the corner furthest along the plane normal
+        const float x = plane[0] > 0.0f ? max[0] : min[0];
+        const float y = plane[1] > 0.0f ? max[1] : min[1];
+        const float z = plane[2] > 0.0f ? max[2] : min[2];
+        if (plane[0] * x + plane[1] * y + plane[2] * z + plane[3] < 0.0f)
+            return false;
+    }
+    return true;
+}
+
+size_t Frustum::cullCubes(const float *x, const float *y, const float *z, size_t count,
+                          float size, uint32_t *visible) const {
+    // for a cube the furthest corner along a normal is min + size wherever
+    // the normal is positive, so that part of the test folds into the
+    // plane's constant and each plane costs three multiply-adds per cube
+    float offset[PLANE_COUNT];
+    for (int p = 0; p < PLANE_COUNT; p++) {
+        const float *plane = this->planes[p];
+        offset[p] = plane[3] + size * (std::max(plane[0], 0.0f)
+                                     + std::max(plane[1], 0.0f)
+                                     + std::max(plane[2], 0.0f));
+    }
+
+    size_t passed = 0;
+    size_t i = 0;
+
+#ifdef FRUSTUM_SSE
+    __m128 a[PLANE_COUNT], b[PLANE_COUNT], c[PLANE_COUNT], d[PLANE_COUNT];
+    for (int p = 0; p < PLANE_COUNT; p++) {
+        a[p] = _mm_set1_ps(this->planes[p][0]);
+        b[p] = _mm_set1_ps(this->planes[p][1]);
+        c[p] = _mm_set1_ps(this->planes[p][2]);
+        d[p] = _mm_set1_ps(offset[p]);
+    }
+    const __m128 zero = _mm_setzero_ps();
+
+    for (; i + 4 <= count; i += 4) {
+        const __m128 vx = _mm_loadu_ps(x + i);
+        const __m128 vy = _mm_loadu_ps(y + i);
+        const __m128 vz = _mm_loadu_ps(z + i);
+
+        __m128 outside = _mm_setzero_ps();
+        for (int p = 0; p < PLANE_COUNT; p++) {
+            __m128 dist = _mm_add_ps(_mm_mul_ps(a[p], vx), d[p]);
+            dist = _mm_add_ps(_mm_mul_ps(b[p], vy), dist);
+            dist = _mm_add_ps(_mm_mul_ps(c[p], vz), dist);
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(dist, zero));
+        }
+
+        // one bit per cube still inside, written out lowest first
+        int inside = ~_mm_movemask_ps(outside) & 0xF;
+        while (inside) {
+            visible[passed++] = i + __builtin_ctz(inside);
+            inside &= inside - 1;
+        }
+    }
+#endif
+
+    for (; i < count; i++) {
+        bool inside = true;
+        for (int p = 0; p < PLANE_COUNT; p++) {
+            const float *plane = this->planes[p];
+            if (plane[0] * x[i] + plane[1] * y[i] + plane[2] * z[i] + offset[p] < 0.0f) {
+                inside = false;
+                break;
+            }
+        }
+        if (inside)
+            visible[passed++] = i;
+    }
+
+    return passed;
+}
+
+void Frustum::cullColumns(const float *x, const float *z, size_t count, float size,
+                          uint64_t *kept) const {
+    // with offset and x and z folded in as in cullCubes(), cube k of a
+    // column passes a plane when dist + b * size * k >= 0. so k is at least
+    // -dist / (b * size) for planes facing up and at most that for planes
+    // facing down, and planes with no y at all keep or drop the column whole
+    float offset[PLANE_COUNT], scale[PLANE_COUNT];
+    for (int p = 0; p < PLANE_COUNT; p++) {
+        const float *plane = this->planes[p];
+        offset[p] = plane[3] + size * (std::max(plane[0], 0.0f)
+                                     + std::max(plane[1], 0.0f)
+                                     + std::max(plane[2], 0.0f));
+        scale[p] = plane[1] != 0.0f ? -1.0f / (plane[1] * size) : 0.0f;
+    }
+
+    // bits first to last, or none when the run is empty
+    auto run = [](int first, int last) -> uint64_t {
+        if (first > last)
+            return 0;
+        return (~uint64_t(0) >> (63 - last)) & (~uint64_t(0) << first);
+    };
+
+    size_t i = 0;
+
+#ifdef FRUSTUM_SSE
+    __m128 a[PLANE_COUNT], c[PLANE_COUNT], d[PLANE_COUNT], s[PLANE_COUNT];
+    for (int p = 0; p < PLANE_COUNT; p++) {
+        a[p] = _mm_set1_ps(this->planes[p][0]);
+        c[p] = _mm_set1_ps(this->planes[p][2]);
+        d[p] = _mm_set1_ps(offset[p]);
+        s[p] = _mm_set1_ps(scale[p]);
+    }
+    const __m128 zero = _mm_setzero_ps();
+
+    for (; i + 4 <= count; i += 4) {
+        const __m128 vx = _mm_loadu_ps(x + i);
+        const __m128 vz = _mm_loadu_ps(z + i);
+
+        __m128 low = _mm_set1_ps(0.0f), high = _mm_set1_ps(63.0f);
+        __m128 outside = _mm_setzero_ps();
+        for (int p = 0; p < PLANE_COUNT; p++) {
+            const __m128 dist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a[p], vx), _mm_mul_ps(c[p], vz)), d[p]);
+            // bound first, so a nan from a plane nearly flat in y leaves the
+            // run as it was
+            const __m128 bound = _mm_mul_ps(dist, s[p]);
+            if (this->planes[p][1] > 0.0f)
+                low = _mm_max_ps(bound, low);
+            else if (this->planes[p][1] < 0.0f)
+                high = _mm_min_ps(bound, high);
+            else
+                outside = _mm_or_ps(outside, _mm_cmplt_ps(dist, zero));
+        }
+
+        // clamped so columns entirely above or below keep nothing, and
+        // rounded inwards: up for low, which is never negative, and down
+        // for high, which is never below -1
+        low = _mm_min_ps(low, _mm_set1_ps(64.0f));
+        high = _mm_add_ps(_mm_max_ps(high, _mm_set1_ps(-1.0f)), _mm_set1_ps(1.0f));
+        __m128i first = _mm_cvttps_epi32(low);
+        first = _mm_sub_epi32(first, _mm_castps_si128(_mm_cmplt_ps(_mm_cvtepi32_ps(first), low)));
+        const __m128i last = _mm_sub_epi32(_mm_cvttps_epi32(high), _mm_set1_epi32(1));
+
+        alignas(16) int32_t firsts[4], lasts[4];
+        _mm_store_si128((__m128i *)firsts, first);
+        _mm_store_si128((__m128i *)lasts, last);
+        const int out = _mm_movemask_ps(outside);
+        for (int k = 0; k < 4; k++)
+            kept[i + k] = (out >> k) & 1 ? 0 : run(firsts[k], lasts[k]);
+    }
+#endif
+
+    for (; i < count; i++) {
+        float low = 0.0f, high = 63.0f;
+        bool outside = false;
+        for (int p = 0; p < PLANE_COUNT; p++) {
+            const float *plane = this->planes[p];
+            const float dist = plane[0] * x[i] + plane[2] * z[i] + offset[p];
+            const float bound = dist * scale[p];
+            if (plane[1] > 0.0f)
+                low = std::max(low, bound);
+            else if (plane[1] < 0.0f)
+                high = std::min(high, bound);
+            else
+                outside |= dist < 0.0f;
+        }
+        const int first = (int)std::ceil(std::min(low, 64.0f));
+        const int last = (int)std::floor(std::max(high, -1.0f));
+        kept[i] = outside ? 0 : run(first, last);
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+static_assert(CHUNK_SECTIONS <= 64, "SectionBounds keeps a column's sections in 64 bits");
+
+void SectionBounds::insert(const SectionPos &pos) {
+    if (pos.y < 0 || pos.y >= CHUNK_SECTIONS)
+        return;
+
+    const uint64_t key = chunkKey(pos.x, pos.z);
+    const uint32_t *found = this->indices.find(key);
+    uint32_t index;
+    if (found) {
+        index = *found;
+    } else {
+        index = this->columns.size();
+        this->indices.insert(key, index);
+        this->columns.push_back({ pos.x, pos.z });
+        this->x.push_back(float(pos.x * SECTION_SIZE));
+        this->z.push_back(float(pos.z * SECTION_SIZE));
+        this->sections.push_back(0);
+    }
+
+    const uint64_t bit = uint64_t(1) << pos.y;
+    this->count += !(this->sections[index] & bit);
+    this->sections[index] |= bit;
+}
+
+void SectionBounds::erase(const SectionPos &pos) {
+    if (pos.y < 0 || pos.y >= CHUNK_SECTIONS)
+        return;
+
+    const uint64_t key = chunkKey(pos.x, pos.z);
+    const uint32_t *found = this->indices.find(key);
+    if (!found)
+        return;
+    const uint32_t index = *found;
+    const uint64_t bit = uint64_t(1) << pos.y;
+    if (!(this->sections[index] & bit))
+        return;
+
+    this->sections[index] &= ~bit;
+    this->count--;
+    if (this->sections[index] != 0)
+        return;
+
+    // the column is empty, fill its hole with the last column to keep the
+    // arrays dense
+    const uint32_t last = this->columns.size() - 1;
+    this->indices.erase(key);
+    if (index != last) {
+        this->columns[index] = this->columns[last];
+        this->x[index] = this->x[last];
+        this->z[index] = this->z[last];
+        this->sections[index] = this->sections[last];
+        this->indices.insert(chunkKey(this->columns[index].x, this->columns[index].z), index);
+    }
+    this->columns.pop_back();
+    this->x.pop_back();
+    this->z.pop_back();
+    this->sections.pop_back();
+}
+
+void SectionBounds::clear() {
+    this->columns.clear();
+    this->x.clear();
+    this->z.clear();
+    this->sections.clear();
+    this->indices.clear();
+    this->count = 0;
+}
+
+size_t SectionBounds::size() const {
+    return this->count;
+}
+
+size_t SectionBounds::cull(const Frustum &frustum, std::vector<SectionPos> &visible) {
+    const size_t columns = this->columns.size();
+    this->kept.resize(columns);
+    frustum.cullColumns(this->x.data(), this->z.data(), columns, (float)SECTION_SIZE,
+                        this->kept.data());
+
+    // counted first so the sections are written straight into place
+    size_t appended = 0;
+    for (size_t i = 0; i < columns; i++) {
+        this->kept[i] &= this->sections[i];
+        appended += __builtin_popcountll(this->kept[i]);
+    }
+
+    size_t out = visible.size();
+    visible.resize(out + appended);
+    for (size_t i = 0; i < columns; i++) {
+        const ChunkPos column = this->columns[i];
+        for (uint64_t bits = this->kept[i]; bits; bits &= bits - 1)
+            visible[out++] = { column.x, int32_t(__builtin_ctzll(bits)), column.z };
+    }
+    return appended;
+}
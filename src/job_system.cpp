@@ -0,0 +1,66 @@
+#include "../include/job_system.hpp"
+#include "../include/profiler.hpp"
+
+#include <string>
+
+JobSystem::JobSystem(unsigned threads) {
+    this->unfinished = 0;
+    this->stopping = false;
+
+    if (threads == 0) {
+        const unsigned hardware = std::thread::hardware_concurrency();
+        threads = hardware > 1 ? hardware - 1 : 1;
+    }
+
+    for (unsigned i = 0; i < threads; i++)
+        this->workers.emplace_back(&JobSystem::work, this, i);
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->stopping = true;
+        this->jobs.clear();
+    }
+    this->wake.notify_all();
+
+    for (std::thread &worker : this->workers)
+        worker.join();
+}
+
+void JobSystem::submit(std::function<void()> job) {
+    this->unfinished++;
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->jobs.push_back(std::move(job));
+    }
+    this->wake.notify_one();
+}
+
+size_t JobSystem::pending() const {
+    return this->unfinished;
+}
+
+unsigned JobSystem::threadCount() const {
+    return this->workers.size();
+}
+
+void JobSystem::work(unsigned index) {
+    Profiler::setThreadName("worker " + std::to_string(index));
+
+    for (;;) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->wake.wait(lock, [this] { return this->stopping || !this->jobs.empty(); });
+            if (this->stopping)
+                return;
+
+            job = std::move(this->jobs.front());
+            this->jobs.pop_front();
+        }
+
+        job();
+        this->unfinished--;
+    }
+}
@@ -0,0 +1,493 @@
+#include "../include/light_engine.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+
+// block offsets of each Block::Face
+static const int FACE_OFFSETS[Block::FACE_COUNT][3] = {
+    { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 }
+};
+
+static inline NibbleArray &channelOf(Chunk *chunk, LightEngine::Channel channel, int y) {
+    LightSection &light = chunk->light[y >> 4];
+    return channel == LightEngine::SKY ? light.sky : light.block;
+}
+
+static inline int localIndex(int x, int y, int z) {
+    return ChunkSection::index(x & 15, y & 15, z & 15);
+}
+
+// shared between lightChunks() and its jobs, which may outlive the call
+struct LightEngine::Batch {
+    LightEngine *owner;
+    std::vector<ChunkPos> chunks;
+    std::atomic<size_t> next;
+    std::mutex mutex;
+    std::condition_variable finished;
+    size_t done;
+};
+
+/* -------------------------------------------------------------------------- */
+LightEngine::LightEngine(World &world) : world(world) {
+    this->last_changed = { INT32_MIN, INT32_MIN, INT32_MIN };
+    this->changed_blocks = 0;
+    this->mark_dirty = true;
+    this->resetCache();
+}
+
+void LightEngine::lightChunk(int32_t cx, int32_t cz) {
+    this->resetCache();
+    Chunk *chunk = this->world.getChunk(cx, cz);
+    if (!chunk)
+        return;
+
+    for (LightSection &light : chunk->light) {
+        light.sky.fill(0);
+        light.block.fill(0);
+    }
+
+    // lowest y of each column with nothing but clear blocks above it
+    const int COLUMNS = SECTION_SIZE * SECTION_SIZE;
+    int top[COLUMNS];
+    int unresolved = COLUMNS;
+    std::fill(top, top + COLUMNS, -1);
+    for (int sy = CHUNK_SECTIONS - 1; sy >= 0 && unresolved > 0; sy--) {
+        const ChunkSection &section = chunk->sections[sy];
+        if (section.isUniform() && Block::opacity[section.get(0)] == 0)
+            continue;
+        for (int c = 0; c < COLUMNS; c++) {
+            if (top[c] >= 0)
+                continue;
+            for (int y = SECTION_SIZE - 1; y >= 0; y--) {
+                if (Block::opacity[section.get(ChunkSection::index(c & 15, y, c >> 4))] != 0) {
+                    top[c] = sy * SECTION_SIZE + y + 1;
+                    unresolved--;
+                    break;
+                }
+            }
+        }
+    }
+    int lowest = CHUNK_HEIGHT, highest = 0;
+    for (int c = 0; c < COLUMNS; c++) {
+        top[c] = std::max(top[c], 0);
+        lowest = std::min(lowest, top[c]);
+        highest = std::max(highest, top[c]);
+    }
+
+    // full sky light down to each column's top. sections wholly above the
+    // terrain stay uniform
+    for (int sy = 0; sy < CHUNK_SECTIONS; sy++) {
+        const int base = sy * SECTION_SIZE;
+        NibbleArray &sky = chunk->light[sy].sky;
+        if (base >= highest) {
+            sky.fill(15);
+            continue;
+        }
+        if (base + SECTION_SIZE <= lowest)
+            continue;
+        for (int c = 0; c < COLUMNS; c++) {
+            for (int y = std::max(top[c], base); y < base + SECTION_SIZE; y++)
+                sky.set(ChunkSection::index(c & 15, y - base, c >> 4), 15);
+        }
+    }
+
+    // the lit blocks that can pass light on: anything down to the highest
+    // top nearby can shine sideways into a lower column, and each column's
+    // last lit block shines down into what stopped the sky
+    const int x0 = cx * SECTION_SIZE, z0 = cz * SECTION_SIZE;
+    for (int c = 0; c < COLUMNS; c++) {
+        for (int y = top[c]; y <= highest && y < CHUNK_HEIGHT; y++)
+            this->adds[SKY].push({ x0 + (c & 15), z0 + (c >> 4), int16_t(y), 0, 0 });
+    }
+
+    // emitters
+    Block::BlockID blocks[SECTION_VOLUME];
+    for (int sy = 0; sy < CHUNK_SECTIONS; sy++) {
+        const ChunkSection &section = chunk->sections[sy];
+        if (section.isUniform() && Block::emission[section.get(0)] == 0)
+            continue;
+        section.unpack(blocks);
+        for (int i = 0; i < SECTION_VOLUME; i++) {
+            const uint8_t emission = Block::emission[blocks[i]];
+            if (emission == 0)
+                continue;
+            chunk->light[sy].block.set(i, emission);
+            this->adds[BLOCK].push({ x0 + (i & 15), z0 + ((i >> 4) & 15),
+                                     int16_t(sy * SECTION_SIZE + (i >> 8)), 0, 0 });
+        }
+    }
+
+    // light already in the four neighbours flows in across the borders.
+    // from the highest top up this chunk already has full sky light
+    for (int face : { Block::POS_X, Block::NEG_X, Block::POS_Z, Block::NEG_Z }) {
+        const int32_t nx = cx + FACE_OFFSETS[face][0], nz = cz + FACE_OFFSETS[face][2];
+        Chunk *neighbour = this->world.getChunk(nx, nz);
+        if (!neighbour)
+            continue;
+
+        // the neighbour's layer touching this chunk
+        const bool along_x = FACE_OFFSETS[face][0] != 0;
+        const int edge = (face & 1) ? SECTION_SIZE - 1 : 0;
+        for (int y = 0; y < CHUNK_HEIGHT; y++) {
+            const LightSection &light = neighbour->light[y >> 4];
+            for (int i = 0; i < SECTION_SIZE; i++) {
+                const int lx = along_x ? edge : i, lz = along_x ? i : edge;
+                const int index = ChunkSection::index(lx, y & 15, lz);
+                const Node node = { nx * SECTION_SIZE + lx, nz * SECTION_SIZE + lz, int16_t(y), 0, 0 };
+                if (y < highest && light.sky.get(index) > 1)
+                    this->adds[SKY].push(node);
+                if (light.block.get(index) > 1)
+                    this->adds[BLOCK].push(node);
+            }
+        }
+    }
+
+    this->propagate(SKY);
+    this->propagate(BLOCK);
+
+    for (LightSection &light : chunk->light) {
+        light.sky.compact();
+        light.block.compact();
+    }
+
+    this->flushChanged();
+}
+
+// the chunk at (x mod 3, z mod 3) of its 3x3 tile. chunks of one colour are
+// at least three apart, so their neighbourhoods never overlap
+static inline int colour(const ChunkPos &pos) {
+    return ((pos.x % 3 + 3) % 3) * 3 + (pos.z % 3 + 3) % 3;
+}
+
+void LightEngine::lightChunks(const std::vector<ChunkPos> &chunks, JobSystem &jobs) {
+    if (chunks.empty())
+        return;
+
+    std::shared_ptr<Batch> batch(new Batch);
+    batch->owner = this;
+    batch->chunks = chunks;
+    batch->next = 0;
+    batch->done = 0;
+    // run one colour after another, so jobs running side by side rarely
+    // wait on each other's locks
+    std::stable_sort(batch->chunks.begin(), batch->chunks.end(), [](const ChunkPos &a, const ChunkPos &b) {
+        return colour(a) < colour(b);
+    });
+
+    const size_t workers = std::min<size_t>(jobs.threadCount(), chunks.size() - 1);
+    for (size_t i = 0; i < workers; i++)
+        jobs.submit([batch] { work(*batch); });
+    work(*batch);
+
+    {
+        std::unique_lock<std::mutex> lock(batch->mutex);
+        batch->finished.wait(lock, [&] { return batch->done == batch->chunks.size(); });
+    }
+
+    // every helper is idle again, hand on what they changed
+    std::lock_guard<std::mutex> lock(this->helper_mutex);
+    for (auto &helper : this->helpers) {
+        for (const SectionPos &pos : helper->changed)
+            this->world.markDirty(pos);
+        helper->changed.clear();
+        helper->last_changed = { INT32_MIN, INT32_MIN, INT32_MIN };
+        helper->changed_blocks = 0;
+    }
+}
+
+void LightEngine::blockChanged(int x, int y, int z) {
+    if (y < 0 || y >= CHUNK_HEIGHT)
+        return;
+    this->edits.push_back({ x, z, int16_t(y), 0, 0 });
+}
+
+size_t LightEngine::update() {
+    if (this->edits.empty())
+        return 0;
+    this->resetCache();
+
+    for (const Node &edit : this->edits) {
+        Chunk *chunk = this->chunkAt(edit.x, edit.z);
+        if (!chunk)
+            continue;
+        const int index = localIndex(edit.x, edit.y, edit.z);
+        const Block::BlockID id = chunk->get(edit.x & 15, edit.y, edit.z & 15);
+
+        for (int channel = 0; channel < CHANNEL_COUNT; channel++) {
+            // whatever the old block passed on has to go first
+            NibbleArray &light = channelOf(chunk, Channel(channel), edit.y);
+            const uint8_t old = light.get(index);
+            if (old != 0) {
+                light.set(index, 0);
+                this->markChanged(edit.x, edit.y, edit.z);
+                this->removes[channel].push({ edit.x, edit.z, edit.y, old, 0 });
+            }
+
+            // then light can flow back in from all around
+            for (int face = 0; face < Block::FACE_COUNT; face++) {
+                const int ny = edit.y + FACE_OFFSETS[face][1];
+                if (ny >= 0 && ny < CHUNK_HEIGHT)
+                    this->adds[channel].push({ edit.x + FACE_OFFSETS[face][0], edit.z + FACE_OFFSETS[face][2],
+                                               int16_t(ny), 0, 0 });
+            }
+        }
+
+        // a new emitter lights itself
+        if (Block::emission[id] != 0) {
+            channelOf(chunk, BLOCK, edit.y).set(index, Block::emission[id]);
+            this->markChanged(edit.x, edit.y, edit.z);
+            this->adds[BLOCK].push(edit);
+        }
+
+        // the top of the world always sees the sky
+        if (edit.y == CHUNK_HEIGHT - 1 && Block::opacity[id] == 0) {
+            channelOf(chunk, SKY, edit.y).set(index, 15);
+            this->adds[SKY].push(edit);
+        }
+    }
+    this->edits.clear();
+
+    for (int channel = 0; channel < CHANNEL_COUNT; channel++) {
+        this->darken(Channel(channel));
+        this->propagate(Channel(channel));
+    }
+
+    const size_t count = this->changed_blocks;
+    this->flushChanged();
+    return count;
+}
+
+uint8_t LightEngine::get(Channel channel, int x, int y, int z) const {
+    if (y >= CHUNK_HEIGHT)
+        return channel == SKY ? 15 : 0;
+    if (y < 0)
+        return 0;
+
+    Chunk *chunk = this->world.getChunk(x >> 4, z >> 4);
+    return chunk ? channelOf(chunk, channel, y).get(localIndex(x, y, z)) : 0;
+}
+
+/* -------------------------------------------------------------------------- */
+LightEngine *LightEngine::acquireHelper() {
+    std::lock_guard<std::mutex> lock(this->helper_mutex);
+    if (this->idle.empty()) {
+        this->helpers.emplace_back(new LightEngine(this->world));
+        this->helpers.back()->mark_dirty = false;
+        return this->helpers.back().get();
+    }
+    LightEngine *helper = this->idle.back();
+    this->idle.pop_back();
+    return helper;
+}
+
+void LightEngine::releaseHelper(LightEngine *helper) {
+    std::lock_guard<std::mutex> lock(this->helper_mutex);
+    this->idle.push_back(helper);
+}
+
+void LightEngine::work(Batch &batch) {
+    for (;;) {
+        const size_t i = batch.next++;
+        if (i >= batch.chunks.size())
+            return;
+        // a claimed chunk keeps the batch unfinished, so the owner is still
+        // waiting in lightChunks() until done is counted below
+        LightEngine *owner = batch.owner;
+        LightEngine *helper = owner->acquireHelper();
+
+        // the stripes of the 3x3 neighbourhood, taken in one global order
+        const ChunkPos pos = batch.chunks[i];
+        int stripes[9];
+        int count = 0;
+        for (int dx = -1; dx <= 1; dx++) {
+            for (int dz = -1; dz <= 1; dz++) {
+                const uint64_t key = chunkKey(pos.x + dx, pos.z + dz);
+                stripes[count++] = int((key * 0x9E3779B97F4A7C15ull) >> 58);
+            }
+        }
+        std::sort(stripes, stripes + count);
+        count = int(std::unique(stripes, stripes + count) - stripes);
+
+        for (int s = 0; s < count; s++)
+            owner->region_locks[stripes[s]].lock();
+        helper->lightChunk(pos.x, pos.z);
+        for (int s = count - 1; s >= 0; s--)
+            owner->region_locks[stripes[s]].unlock();
+        owner->releaseHelper(helper);
+
+        std::lock_guard<std::mutex> lock(batch.mutex);
+        if (++batch.done == batch.chunks.size())
+            batch.finished.notify_all();
+    }
+}
+
+void LightEngine::flushChanged() {
+    if (!this->mark_dirty)
+        return;
+    for (const SectionPos &pos : this->changed)
+        this->world.markDirty(pos);
+    this->changed.clear();
+    this->last_changed = { INT32_MIN, INT32_MIN, INT32_MIN };
+    this->changed_blocks = 0;
+}
+
+/* -------------------------------------------------------------------------- */
+Chunk *LightEngine::chunkAt(int x, int z) {
+    const int32_t cx = x >> 4, cz = z >> 4;
+    if (cx != this->cached_x || cz != this->cached_z) {
+        this->cached = this->world.getChunk(cx, cz);
+        this->cached_x = cx;
+        this->cached_z = cz;
+    }
+    return this->cached;
+}
+
+// chunks may have been loaded or unloaded since the last call
+void LightEngine::resetCache() {
+    this->cached = nullptr;
+    this->cached_x = INT32_MIN;
+    this->cached_z = INT32_MIN;
+}
+
+// remembers the section holding a block whose light changed, and the
+// neighbour whose faces it lights if it sits on the border
+void LightEngine::markChanged(int x, int y, int z) {
+    this->changed_blocks++;
+
+    const SectionPos pos = { x >> 4, y >> 4, z >> 4 };
+    const int local[3] = { x & 15, y & 15, z & 15 };
+    const bool border = local[0] == 0 || local[0] == 15 || local[1] == 0 || local[1] == 15
+                     || local[2] == 0 || local[2] == 15;
+    if (!border) {
+        if (pos == this->last_changed)
+            return;
+        this->last_changed = pos;
+        this->changed.insert(pos);
+        return;
+    }
+
+    forEachSectionTouching(x, y, z, [this](SectionPos touched) { this->changed.insert(touched); });
+}
+
+template <typename Step>
+void LightEngine::flushBorder(Step &&step) {
+    // sorting by chunk lets each chunk be looked up once per flush
+    std::sort(this->border.begin(), this->border.end(), [](const Node &a, const Node &b) {
+        return chunkKey(a.x >> 4, a.z >> 4) < chunkKey(b.x >> 4, b.z >> 4);
+    });
+    for (const Node &node : this->border) {
+        Chunk *chunk = this->chunkAt(node.x, node.z);
+        if (chunk)
+            step(chunk, node);
+    }
+    this->border.clear();
+}
+
+void LightEngine::propagate(Channel channel) {
+    Queue &queue = this->adds[channel];
+    for (;;) {
+        while (!queue.empty()) {
+            const Node node = queue.pop();
+            Chunk *chunk = this->chunkAt(node.x, node.z);
+            if (!chunk)
+                continue;
+            const uint8_t level = channelOf(chunk, channel, node.y).get(localIndex(node.x, node.y, node.z));
+            if (level <= 1)
+                continue;
+
+            for (int face = 0; face < Block::FACE_COUNT; face++) {
+                Node next = { node.x + FACE_OFFSETS[face][0], node.z + FACE_OFFSETS[face][2],
+                              int16_t(node.y + FACE_OFFSETS[face][1]), level, uint8_t(face) };
+                if (next.y < 0 || next.y >= CHUNK_HEIGHT)
+                    continue;
+                if ((next.x >> 4) != (node.x >> 4) || (next.z >> 4) != (node.z >> 4))
+                    this->border.push_back(next);
+                else
+                    this->spreadInto(channel, chunk, next, level);
+            }
+        }
+
+        if (this->border.empty())
+            return;
+        this->flushBorder([&](Chunk *chunk, const Node &node) {
+            this->spreadInto(channel, chunk, node, node.level);
+        });
+    }
+}
+
+void LightEngine::darken(Channel channel) {
+    Queue &queue = this->removes[channel];
+    for (;;) {
+        while (!queue.empty()) {
+            const Node node = queue.pop();
+            Chunk *chunk = this->chunkAt(node.x, node.z);
+            if (!chunk)
+                continue;
+
+            for (int face = 0; face < Block::FACE_COUNT; face++) {
+                Node next = { node.x + FACE_OFFSETS[face][0], node.z + FACE_OFFSETS[face][2],
+                              int16_t(node.y + FACE_OFFSETS[face][1]), node.level, uint8_t(face) };
+                if (next.y < 0 || next.y >= CHUNK_HEIGHT)
+                    continue;
+                if ((next.x >> 4) != (node.x >> 4) || (next.z >> 4) != (node.z >> 4))
+                    this->border.push_back(next);
+                else
+                    this->darkenInto(channel, chunk, next, node.level);
+            }
+        }
+
+        if (this->border.empty())
+            return;
+        this->flushBorder([&](Chunk *chunk, const Node &node) {
+            this->darkenInto(channel, chunk, node, node.level);
+        });
+    }
+}
+
+void LightEngine::spreadInto(Channel channel, Chunk *chunk, const Node &node, uint8_t level) {
+    const int index = localIndex(node.x, node.y, node.z);
+    const uint8_t opacity = Block::opacity[chunk->sections[node.y >> 4].get(index)];
+
+    int next = level - std::max<int>(opacity, 1);
+    if (channel == SKY && level == 15 && opacity == 0 && node.face == Block::NEG_Y)
+        next = 15;
+
+    NibbleArray &light = channelOf(chunk, channel, node.y);
+    if (next <= light.get(index))
+        return;
+    light.set(index, next);
+    this->markChanged(node.x, node.y, node.z);
+    this->adds[channel].push(node);
+}
+
+void LightEngine::darkenInto(Channel channel, Chunk *chunk, const Node &node, uint8_t level) {
+    const int index = localIndex(node.x, node.y, node.z);
+    NibbleArray &light = channelOf(chunk, channel, node.y);
+    const uint8_t current = light.get(index);
+    if (current == 0)
+        return;
+
+    // dimmer light came from the darkened block (full sky light straight
+    // below it did too), brighter or equal light has another source and
+    // has to spread back in once the darkening is done
+    const bool fed = current < level
+                  || (channel == SKY && level == 15 && current == 15 && node.face == Block::NEG_Y);
+    if (!fed) {
+        this->adds[channel].push(node);
+        return;
+    }
+
+    light.set(index, 0);
+    this->markChanged(node.x, node.y, node.z);
+    this->removes[channel].push({ node.x, node.z, node.y, current, node.face });
+
+    // emitters relight themselves
+    if (channel == BLOCK) {
+        const uint8_t emission = Block::emission[chunk->sections[node.y >> 4].get(index)];
+        if (emission != 0) {
+            light.set(index, emission);
+            this->adds[BLOCK].push(node);
+        }
+    }
+}
@@ -0,0 +1,84 @@
+#include "../include/lod.hpp"
+#include "../include/block.hpp"
+
+#include <cmath>
+
+// chunks beyond which each level starts, level 0 from the camera out
+static const float lod_distance[LOD_LEVELS] = { 0.0f, LOD1_DISTANCE, LOD2_DISTANCE };
+
+void LodSelector::update(float x, float y, float z, std::vector<SectionPos> &changed) {
+    this->x = x;
+    this->y = y;
+    this->z = z;
+
+    const SectionPos camera = { int32_t(std::floor(x / SECTION_SIZE)), int32_t(std::floor(y / SECTION_SIZE)),
+                                int32_t(std::floor(z / SECTION_SIZE)) };
+    if (camera == this->camera)
+        return;
+    this->camera = camera;
+
+    for (auto &entry : this->levels) {
+        const int level = this->choose(entry.first, entry.second);
+        if (level != entry.second) {
+            entry.second = level;
+            changed.push_back(entry.first);
+        }
+    }
+}
+
+int LodSelector::level(SectionPos pos) {
+    auto it = this->levels.find(pos);
+    if (it != this->levels.end())
+        return it->second;
+
+    const int level = this->choose(pos, -1);
+    this->levels[pos] = level;
+    return level;
+}
+
+uint8_t LodSelector::skirts(SectionPos pos) {
+    const int level = this->level(pos);
+
+    uint8_t skirts = 0;
+    for (int face = 0; face < Block::FACE_COUNT; face++) {
+        // neighbours not meshed yet get the level they will be given
+        const SectionPos next = pos.neighbour(face);
+        auto it = this->levels.find(next);
+        const int other = it != this->levels.end() ? it->second : this->choose(next, -1);
+        if (other != level)
+            skirts |= 1 << face;
+    }
+    return skirts;
+}
+
+void LodSelector::erase(SectionPos pos) {
+    this->levels.erase(pos);
+}
+
+void LodSelector::clear() {
+    this->levels.clear();
+}
+
+/* -------------------------------------------------------------------------- */
+int LodSelector::choose(SectionPos pos, int current) const {
+    const float half = SECTION_SIZE / 2.0f;
+    const float dx = pos.x * SECTION_SIZE + half - this->x;
+    const float dy = pos.y * SECTION_SIZE + half - this->y;
+    const float dz = pos.z * SECTION_SIZE + half - this->z;
+    const float chunks = std::sqrt(dx * dx + dy * dy + dz * dz) / SECTION_SIZE;
+
+    int level = 0;
+    if (current < 0) {
+        while (level + 1 < LOD_LEVELS && chunks >= lod_distance[level + 1])
+            level++;
+        return level;
+    }
+
+    // step away from the current level only once clearly past a boundary
+    level = current;
+    while (level + 1 < LOD_LEVELS && chunks >= lod_distance[level + 1] + LOD_HYSTERESIS)
+        level++;
+    while (level > 0 && chunks < lod_distance[level] - LOD_HYSTERESIS)
+        level--;
+    return level;
+}
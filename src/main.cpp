@@ -9,9 +9,20 @@
 #include "../include/window.hpp"
 #include "../include/shader.hpp"
 
+#include "../include/profiler.hpp"
+
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 
-int main() {
+int main(int argc, char **argv) {
+    // --trace <frames> writes the first n frames to trace.json, open it in
+    // chrome://tracing or ui.perfetto.dev
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+            Profiler::startCapture(std::atoi(argv[++i]), "trace.json");
+    }
+
     Window window;
     window.windowLoop();
 }
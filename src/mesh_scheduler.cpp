@@ -0,0 +1,114 @@
+#include "../include/mesh_scheduler.hpp"
+#include "../include/clock.hpp"
+#include "../include/lod.hpp"
+#include "../include/profiler.hpp"
+
+// everything a meshing job reads, copied on the main thread: the section
+// and the 26 around it, with their light, in PaddedSection::around() slots.
+// palette compression and uniform light arrays keep the copies small.
+struct MeshSnapshot {
+    SectionPos pos;
+    uint32_t version;
+    int lod;
+    uint8_t skirts;
+    ChunkSection sections[PaddedSection::NEIGHBOURHOOD];
+    LightSection light[PaddedSection::NEIGHBOURHOOD];
+    bool present[PaddedSection::NEIGHBOURHOOD];
+};
+
+MeshScheduler::MeshScheduler(JobSystem &jobs) : jobs(jobs) {
+    this->finished = std::make_shared<MpscQueue<MeshResult>>();
+    this->in_flight = 0;
+    this->next_version = 0;
+}
+
+void MeshScheduler::schedule(const World &world, SectionPos pos, int lod, uint8_t skirts) {
+    PROFILE_ZONE("mesh snapshot");
+
+    const ChunkSection *center = world.getSection(pos);
+    if (!center)
+        return;
+
+    std::shared_ptr<MeshSnapshot> snapshot = std::make_shared<MeshSnapshot>();
+    snapshot->pos = pos;
+    snapshot->version = this->versions[pos] = ++this->next_version;
+    snapshot->lod = lod;
+    snapshot->skirts = skirts;
+    // one chunk lookup per column of the neighbourhood
+    for (int dz = -1; dz <= 1; dz++) {
+        for (int dx = -1; dx <= 1; dx++) {
+            const Chunk *chunk = world.getChunk(pos.x + dx, pos.z + dz);
+            for (int dy = -1; dy <= 1; dy++) {
+                const int slot = PaddedSection::around(dx, dy, dz);
+                const int y = pos.y + dy;
+                snapshot->present[slot] = chunk && y >= 0 && y < CHUNK_SECTIONS;
+                if (snapshot->present[slot]) {
+                    snapshot->sections[slot] = chunk->sections[y];
+                    snapshot->light[slot] = chunk->light[y];
+                }
+            }
+        }
+    }
+
+    this->in_flight++;
+
+    std::shared_ptr<MpscQueue<MeshResult>> finished = this->finished;
+    this->jobs.submit([snapshot, finished] {
+        PROFILE_ZONE("mesh");
+
+        const ChunkSection *sections[PaddedSection::NEIGHBOURHOOD];
+        const LightSection *light[PaddedSection::NEIGHBOURHOOD];
+        for (int slot = 0; slot < PaddedSection::NEIGHBOURHOOD; slot++) {
+            sections[slot] = snapshot->present[slot] ? &snapshot->sections[slot] : nullptr;
+            light[slot] = snapshot->present[slot] ? &snapshot->light[slot] : nullptr;
+        }
+
+        // too big for a worker's stack to want a fresh one per job
+        thread_local std::unique_ptr<PaddedSection> padded(new PaddedSection);
+        padded->load(sections);
+        padded->loadLight(light);
+        if (snapshot->lod > 0 || snapshot->skirts != 0) {
+            const ChunkSection *neighbours[Block::FACE_COUNT];
+            for (int face = 0; face < Block::FACE_COUNT; face++)
+                neighbours[face] = sections[PaddedSection::faceSlot(face)];
+            padded->downsample(lodScale(snapshot->lod), snapshot->skirts, neighbours);
+        }
+
+        MeshResult result;
+        result.pos = snapshot->pos;
+        result.version = snapshot->version;
+        binaryMesh(*padded, result.mesh);
+        result.faces = sectionConnections(snapshot->sections[PaddedSection::around(0, 0, 0)]);
+        finished->push(std::move(result));
+    });
+}
+
+void MeshScheduler::cancel(SectionPos pos) {
+    this->versions.erase(pos);
+}
+
+size_t MeshScheduler::drain(uint64_t budget_ns, const std::function<void(MeshResult &)> &upload) {
+    const uint64_t start = monotonicNs();
+
+    size_t handled = 0;
+    MeshResult result;
+    while (this->finished->pop(result)) {
+        this->in_flight--;
+
+        // stale if the section was scheduled again or cancelled meanwhile
+        auto it = this->versions.find(result.pos);
+        if (it == this->versions.end() || it->second != result.version)
+            continue;
+
+        upload(result);
+        handled++;
+
+        if (monotonicNs() - start >= budget_ns)
+            break;
+    }
+    return handled;
+}
+
+size_t MeshScheduler::inFlight() const {
+    return this->in_flight;
+}
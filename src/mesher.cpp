@@ -0,0 +1,607 @@
+#include "../include/mesher.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+/* -------------------------------------------------------------------------- */
+int PaddedSection::faceSlot(int face) {
+    int offset[3] = { 0, 0, 0 };
+    offset[face >> 1] = (face & 1) ? -1 : 1;
+    return around(offset[0], offset[1], offset[2]);
+}
+
+// the padded coordinates along one axis covered by the section offset by d
+// along it. subtracting d * SECTION_SIZE gives its own coordinates
+static inline void borderRange(int d, int &low, int &high) {
+    low = d < 0 ? -1 : d > 0 ? SECTION_SIZE : 0;
+    high = d == 0 ? SECTION_SIZE - 1 : low;
+}
+
+void PaddedSection::load(const ChunkSection &center, const ChunkSection *const neighbours[Block::FACE_COUNT]) {
+    const int S = SECTION_SIZE;
+
+    std::fill(this->blocks, this->blocks + VOLUME, Block::AIR);
+    std::fill(this->light, this->light + VOLUME, 15);
+    this->smooth = true;
+
+    Block::BlockID inner[SECTION_VOLUME];
+    center.unpack(inner);
+    for (int y = 0; y < S; y++) {
+        for (int z = 0; z < S; z++) {
+            std::memcpy(&this->blocks[index(0, y, z)],
+                        &inner[ChunkSection::index(0, y, z)],
+                        S * sizeof(Block::BlockID));
+        }
+    }
+
+    // copy the touching layer of each face neighbour into the border
+    for (int face = 0; face < Block::FACE_COUNT; face++) {
+        const ChunkSection *neighbour = neighbours[face];
+        if (!neighbour || neighbour->isEmpty())
+            continue;
+
+        const int axis = face >> 1;
+        const int u = (axis + 1) % 3, v = (axis + 2) % 3;
+        // positive neighbours touch us with their first layer, negative
+        // neighbours with their last
+        const int src = (face & 1) ? S - 1 : 0;
+        const int dst = (face & 1) ? -1 : S;
+
+        for (int j = 0; j < S; j++) {
+            for (int i = 0; i < S; i++) {
+                int from[3], to[3];
+                from[axis] = src;
+                to[axis] = dst;
+                from[u] = to[u] = i;
+                from[v] = to[v] = j;
+                this->blocks[index(to[0], to[1], to[2])] = neighbour->get(from[0], from[1], from[2]);
+            }
+        }
+    }
+}
+
+void PaddedSection::load(const ChunkSection *const sections[NEIGHBOURHOOD]) {
+    const ChunkSection *neighbours[Block::FACE_COUNT];
+    for (int face = 0; face < Block::FACE_COUNT; face++)
+        neighbours[face] = sections[faceSlot(face)];
+    this->load(*sections[around(0, 0, 0)], neighbours);
+
+    // the edges and corners, from the sections off more than one axis
+    for (int dy = -1; dy <= 1; dy++) {
+        for (int dz = -1; dz <= 1; dz++) {
+            for (int dx = -1; dx <= 1; dx++) {
+                const ChunkSection *section = sections[around(dx, dy, dz)];
+                if ((dx != 0) + (dy != 0) + (dz != 0) < 2 || !section || section->isEmpty())
+                    continue;
+
+                int low[3], high[3];
+                borderRange(dx, low[0], high[0]);
+                borderRange(dy, low[1], high[1]);
+                borderRange(dz, low[2], high[2]);
+                for (int y = low[1]; y <= high[1]; y++)
+                    for (int z = low[2]; z <= high[2]; z++)
+                        for (int x = low[0]; x <= high[0]; x++)
+                            this->blocks[index(x, y, z)] = section->get(x - dx * SECTION_SIZE,
+                                                                        y - dy * SECTION_SIZE,
+                                                                        z - dz * SECTION_SIZE);
+            }
+        }
+    }
+}
+
+void PaddedSection::loadLight(const LightSection *const light[NEIGHBOURHOOD]) {
+    for (int dy = -1; dy <= 1; dy++) {
+        for (int dz = -1; dz <= 1; dz++) {
+            for (int dx = -1; dx <= 1; dx++) {
+                const LightSection *section = light[around(dx, dy, dz)];
+                int low[3], high[3];
+                borderRange(dx, low[0], high[0]);
+                borderRange(dy, low[1], high[1]);
+                borderRange(dz, low[2], high[2]);
+
+                // most sections are all sky or all dark, fill those
+                const bool uniform = !section || (section->sky.isUniform() && section->block.isUniform());
+                const uint8_t level = !section ? 15 : std::max(section->sky.get(0), section->block.get(0));
+                for (int y = low[1]; y <= high[1]; y++) {
+                    for (int z = low[2]; z <= high[2]; z++) {
+                        uint8_t *row = &this->light[index(low[0], y, z)];
+                        if (uniform) {
+                            std::fill(row, row + high[0] - low[0] + 1, level);
+                            continue;
+                        }
+                        const int from = ChunkSection::index(low[0] - dx * SECTION_SIZE,
+                                                             y - dy * SECTION_SIZE,
+                                                             z - dz * SECTION_SIZE);
+                        for (int x = 0; x <= high[0] - low[0]; x++)
+                            row[x] = std::max(section->sky.get(from + x), section->block.get(from + x));
+                    }
+                }
+            }
+        }
+    }
+}
+
+// the block a downsampled cell becomes, given how often each block occurs
+static Block::BlockID majority(const uint16_t counts[Block::BLOCK_COUNT], int cells) {
+    if (counts[Block::AIR] * 2 > cells)
+        return Block::AIR;
+
+    int best = Block::AIR, best_count = 0;
+    for (int id = 1; id < Block::BLOCK_COUNT; id++) {
+        if (counts[id] > best_count) {
+            best = id;
+            best_count = counts[id];
+        }
+    }
+    return (Block::BlockID)best;
+}
+
+void PaddedSection::downsample(int scale, uint8_t skirts, const ChunkSection *const neighbours[Block::FACE_COUNT]) {
+    const int S = SECTION_SIZE;
+    const int cells = scale * scale * scale;
+
+    if (scale > 1) {
+        // a cell's faces would split wherever the shading under them
+        // changes, and from afar it doesn't show
+        this->smooth = false;
+        for (int cy = 0; cy < S; cy += scale) {
+            for (int cz = 0; cz < S; cz += scale) {
+                for (int cx = 0; cx < S; cx += scale) {
+                    uint16_t counts[Block::BLOCK_COUNT] = {};
+                    for (int y = cy; y < cy + scale; y++)
+                        for (int z = cz; z < cz + scale; z++)
+                            for (int x = cx; x < cx + scale; x++)
+                                counts[this->get(x, y, z)]++;
+
+                    const Block::BlockID id = majority(counts, cells);
+                    for (int y = cy; y < cy + scale; y++)
+                        for (int z = cz; z < cz + scale; z++)
+                            std::fill(&this->blocks[index(cx, y, z)], &this->blocks[index(cx + scale, y, z)], id);
+                }
+            }
+        }
+    }
+
+    for (int face = 0; face < Block::FACE_COUNT; face++) {
+        const bool skirt = (skirts >> face) & 1;
+        const ChunkSection *neighbour = neighbours[face];
+        if (!skirt && (scale == 1 || !neighbour || neighbour->isEmpty()))
+            continue;
+
+        const int axis = face >> 1;
+        const int u = (axis + 1) % 3, v = (axis + 2) % 3;
+        // the neighbour's cells touching us, and our border layer
+        const int src = (face & 1) ? S - scale : 0;
+        const int dst = (face & 1) ? -1 : S;
+
+        for (int cj = 0; cj < S; cj += scale) {
+            for (int ci = 0; ci < S; ci += scale) {
+                Block::BlockID id = Block::AIR;
+                if (!skirt) {
+                    uint16_t counts[Block::BLOCK_COUNT] = {};
+                    int from[3];
+                    for (int d = src; d < src + scale; d++) {
+                        for (int j = cj; j < cj + scale; j++) {
+                            for (int i = ci; i < ci + scale; i++) {
+                                from[axis] = d;
+                                from[u] = i;
+                                from[v] = j;
+                                counts[neighbour->get(from[0], from[1], from[2])]++;
+                            }
+                        }
+                    }
+                    id = majority(counts, cells);
+                }
+
+                int to[3];
+                to[axis] = dst;
+                for (int j = cj; j < cj + scale; j++) {
+                    for (int i = ci; i < ci + scale; i++) {
+                        to[u] = i;
+                        to[v] = j;
+                        this->blocks[index(to[0], to[1], to[2])] = id;
+                    }
+                }
+            }
+        }
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+void ChunkMesh::clear() {
+    this->vertices.clear();
+    this->indices.clear();
+}
+
+size_t ChunkMesh::quads() const {
+    return this->vertices.size() / 4;
+}
+
+/* -------------------------------------------------------------------------- */
+// shading of a face's four corners in emitQuad's corner order, 6 bits each:
+// ambient occlusion in the low 2 and light in the high 4
+static const uint32_t FLAT_SHADE = 0xFFFFFF;
+
+// the eight blocks around the one in front of a face, in the plane of the
+// face, go round from the (-u, -v) corner: (-u, -v), -v, (+u, -v), +u,
+// (+u, +v), +v, (-u, +v), -u. each corner of the face sees three of them,
+// the two beside it along u and v and the one diagonal to it
+static const int RING_U[8] = { -1, 0, 1, 1, 1, 0, -1, -1 };
+static const int RING_V[8] = { -1, -1, -1, 0, 1, 1, 1, 0 };
+static const int CORNER_RING[4][3] = { { 7, 1, 0 }, { 3, 1, 2 }, { 3, 5, 4 }, { 7, 5, 6 } };
+
+// per pattern of opaque ring blocks, the ambient occlusion of every corner
+// packed as in a shade, and for each corner 3 bits of which of its side u,
+// side v and diagonal blocks light can come through. also the padded index
+// offsets of the block in front of each face and of the ring around it
+struct CornerTable {
+    uint32_t ao[256];
+    uint16_t open[256];
+    int front[Block::FACE_COUNT];
+    int ring[3][8];
+
+    CornerTable() {
+        const int stride[3] = { 1, PaddedSection::SIZE * PaddedSection::SIZE, PaddedSection::SIZE };
+        for (int face = 0; face < Block::FACE_COUNT; face++)
+            this->front[face] = (face & 1) ? -stride[face >> 1] : stride[face >> 1];
+        for (int axis = 0; axis < 3; axis++)
+            for (int n = 0; n < 8; n++)
+                this->ring[axis][n] = RING_U[n] * stride[(axis + 1) % 3] + RING_V[n] * stride[(axis + 2) % 3];
+
+        for (int mask = 0; mask < 256; mask++) {
+            this->ao[mask] = 0;
+            this->open[mask] = 0;
+            for (int c = 0; c < 4; c++) {
+                const bool side_u = (mask >> CORNER_RING[c][0]) & 1;
+                const bool side_v = (mask >> CORNER_RING[c][1]) & 1;
+                // both sides closed hide the diagonal block from the corner
+                const bool diagonal = (side_u && side_v) || ((mask >> CORNER_RING[c][2]) & 1);
+                const int ao = side_u && side_v ? 0 : 3 - side_u - side_v - diagonal;
+                this->ao[mask] |= uint32_t(ao) << (6 * c);
+                const int feeds = (!side_u) | ((!side_v) << 1) | ((!diagonal) << 2);
+                this->open[mask] |= feeds << (3 * c);
+            }
+        }
+    }
+};
+
+static const CornerTable corners;
+
+// shades the face of the block at (x, y, z) on the given side from the
+// layer of blocks in front of it
+static inline uint32_t faceShade(const PaddedSection &section, int face, int x, int y, int z) {
+    if (!section.smooth)
+        return FLAT_SHADE;
+
+    const int axis = face >> 1;
+    const int front = PaddedSection::index(x, y, z) + corners.front[face];
+    const int *offset = corners.ring[axis];
+
+    int mask = 0;
+    bool uniform = true;
+    const uint8_t center = section.light[front];
+    for (int n = 0; n < 8; n++) {
+        mask |= Block::isOpaque(section.blocks[front + offset[n]]) << n;
+        uniform &= section.light[front + offset[n]] == center;
+    }
+
+    // whichever blocks the light is averaged over, open sky and dark caves
+    // give the same level at every corner
+    if (uniform)
+        return corners.ao[mask] | uint32_t(center) * 0x104104;
+
+    // rounded averages of 1 to 4 levels, as a multiply and shift
+    static const int reciprocal[5] = { 0, 4096, 2048, 1366, 1024 };
+    uint32_t shade = corners.ao[mask];
+    for (int c = 0; c < 4; c++) {
+        const int open = (corners.open[mask] >> (3 * c)) & 7;
+        int sum = center, count = 1;
+        for (int k = 0; k < 3; k++) {
+            if ((open >> k) & 1) {
+                sum += section.light[front + offset[CORNER_RING[c][k]]];
+                count++;
+            }
+        }
+        const int light = ((2 * sum + count) * reciprocal[count]) >> 13;
+        shade |= uint32_t(light) << (6 * c + 2);
+    }
+    return shade;
+}
+
+// appends a w by h quad on the given face of the layer at slice. (i, j) is
+// the quad's minimum corner along the face's u and v axes, which are the two
+// axes following the face axis in x, y, z order.
+static void emitQuad(ChunkMesh &mesh, int face, int slice, int i, int j, int w, int h, int tile, uint32_t shade) {
+    const int axis = face >> 1;
+    const int u = (axis + 1) % 3, v = (axis + 2) % 3;
+
+    int corner[4][3];
+    for (int c = 0; c < 4; c++)
+        corner[c][axis] = slice + ((face & 1) ? 0 : 1);
+    corner[0][u] = i;     corner[0][v] = j;
+    corner[1][u] = i + w; corner[1][v] = j;
+    corner[2][u] = i + w; corner[2][v] = j + h;
+    corner[3][u] = i;     corner[3][v] = j + h;
+
+    const uint32_t base = mesh.vertices.size();
+    int brightness[4];
+    for (int c = 0; c < 4; c++) {
+        const int ao = (shade >> (6 * c)) & 3, light = (shade >> (6 * c + 2)) & 15;
+        brightness[c] = (ao + 1) * (light + 1);
+        mesh.vertices.push_back(ChunkVertex::pack(corner[c][0], corner[c][1], corner[c][2], face, ao, light, tile));
+    }
+
+    // u cross v points along +axis, so positive faces wind 0-1-2 and
+    // negative faces wind the other way to stay counter-clockwise. the
+    // quad is split along its brighter diagonal, so one dark corner shades
+    // a single triangle instead of a streak through the middle
+    static const uint32_t positive[2][6] = { { 0, 1, 2, 0, 2, 3 }, { 1, 2, 3, 1, 3, 0 } };
+    static const uint32_t negative[2][6] = { { 0, 2, 1, 0, 3, 2 }, { 1, 3, 2, 1, 0, 3 } };
+    const int flip = brightness[1] + brightness[3] > brightness[0] + brightness[2];
+    const uint32_t *order = (face & 1) ? negative[flip] : positive[flip];
+    for (int k = 0; k < 6; k++)
+        mesh.indices.push_back(base + order[k]);
+}
+
+void greedyMesh(const PaddedSection &section, ChunkMesh &mesh) {
+    const int S = SECTION_SIZE;
+    // shade << 8 | tile, plus 1, of the visible face at each cell of the
+    // current slice, 0 if there is no face
+    uint64_t mask[SECTION_SIZE * SECTION_SIZE];
+
+    mesh.clear();
+
+    for (int face = 0; face < Block::FACE_COUNT; face++) {
+        const int axis = face >> 1;
+        const int u = (axis + 1) % 3, v = (axis + 2) % 3;
+        const int step = (face & 1) ? -1 : 1;
+
+        for (int slice = 0; slice < S; slice++) {
+            bool any = false;
+
+            for (int j = 0; j < S; j++) {
+                for (int i = 0; i < S; i++) {
+                    int pos[3];
+                    pos[axis] = slice;
+                    pos[u] = i;
+                    pos[v] = j;
+                    const Block::BlockID block = section.get(pos[0], pos[1], pos[2]);
+                    const Block::BlockID neighbour = section.get(pos[0] + (axis == 0) * step,
+                                                                 pos[1] + (axis == 1) * step,
+                                                                 pos[2] + (axis == 2) * step);
+
+                    const bool visible = Block::isFaceVisible(block, neighbour);
+                    mask[j * S + i] = visible ? (uint64_t(faceShade(section, face, pos[0], pos[1], pos[2])) << 8
+                                                 | Block::tile[face][block]) + 1 : 0;
+                    any |= visible;
+                }
+            }
+
+            if (!any)
+                continue;
+
+            // grow each unvisited face as far as it goes along u, then extend
+            // that run along v while every cell of the next row matches
+            for (int j = 0; j < S; j++) {
+                for (int i = 0; i < S; i++) {
+                    const uint64_t key = mask[j * S + i];
+                    if (key == 0)
+                        continue;
+
+                    int w = 1;
+                    while (i + w < S && mask[j * S + i + w] == key)
+                        w++;
+
+                    int h = 1;
+                    for (; j + h < S; h++) {
+                        const uint64_t *row = &mask[(j + h) * S + i];
+                        if (std::count(row, row + w, key) != w)
+                            break;
+                    }
+
+                    emitQuad(mesh, face, slice, i, j, w, h, (key - 1) & 255, uint32_t((key - 1) >> 8));
+
+                    for (int y = 0; y < h; y++)
+                        std::fill(&mask[(j + y) * S + i], &mask[(j + y) * S + i + w], 0);
+                    i += w - 1;
+                }
+            }
+        }
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+// the plane of each (slice, tile, shade) key seen on one side of a section,
+// found by open addressing. a side has at most SECTION_VOLUME faces, so the
+// table is never more than half full. entries from earlier sides are told
+// apart by their stamp rather than cleared.
+struct PlaneTable {
+    static const int BITS = 13;
+    static const int CAPACITY = 1 << BITS;
+
+    // kept together so a probe touches one cache line
+    struct Entry {
+        uint64_t key;
+        int32_t slot;
+        uint32_t stamp;
+    };
+
+    Entry entries[CAPACITY] = {};
+    uint32_t stamp = 0;
+
+    void clear() {
+        if (++this->stamp == 0) {
+            for (Entry &entry : this->entries)
+                entry.stamp = 0;
+            this->stamp = 1;
+        }
+    }
+
+    // the slot stored for key, -1 for the caller to fill in if it's new
+    int32_t &find(uint64_t key) {
+        size_t i = (key * 0x9E3779B97F4A7C15ull) >> (64 - BITS);
+        while (this->entries[i].stamp == this->stamp && this->entries[i].key != key)
+            i = (i + 1) & (CAPACITY - 1);
+        Entry &entry = this->entries[i];
+        if (entry.stamp != this->stamp) {
+            entry.stamp = this->stamp;
+            entry.key = key;
+            entry.slot = -1;
+        }
+        return entry.slot;
+    }
+};
+
+static_assert(PlaneTable::CAPACITY >= 2 * SECTION_VOLUME, "PlaneTable must stay at most half full");
+
+void binaryMesh(const PaddedSection &section, ChunkMesh &mesh) {
+    const int S = SECTION_SIZE, P = PaddedSection::SIZE;
+    // bits 1 to S of a column are the blocks inside the section
+    const uint64_t inner = ((uint64_t(1) << S) - 1) << 1;
+
+    // one word per column along each axis, bit k of the low half set if the
+    // block at padded coordinate k along that axis is filled and bit k of the
+    // high half set if it's opaque. columns are indexed v * P + u with u and v
+    // the two axes following the column axis, as in emitQuad.
+    uint64_t columns[3][P * P] = {};
+
+    for (int y = 0; y < P; y++) {
+        for (int z = 0; z < P; z++) {
+            const Block::BlockID *row = &section.blocks[(y * P + z) * P];
+            uint64_t x_column = 0;
+
+            for (int x = 0; x < P; x++) {
+                const uint64_t bits = uint64_t(row[x] != Block::AIR)
+                                    | uint64_t(Block::isOpaque(row[x])) << 32;
+                x_column |= bits << x;
+                columns[1][x * P + z] |= bits << y;
+                columns[2][y * P + x] |= bits << z;
+            }
+
+            // a row along x is already a whole x column
+            columns[0][z * P + y] = x_column;
+        }
+    }
+
+    // visible faces regrouped into one bit plane per (slice, tile, shade),
+    // rows along v with bit i of a row set for the face at u = i. each
+    // plane's key also holds the first row it has faces in, above bit 48,
+    // since shaded planes often hold a face or two
+    thread_local std::vector<uint32_t> planes;
+    thread_local std::vector<uint64_t> plane_keys;
+    thread_local std::unique_ptr<PlaneTable> table(new PlaneTable);
+
+    mesh.clear();
+
+    for (int face = 0; face < Block::FACE_COUNT; face++) {
+        const int axis = face >> 1;
+        const int u = (axis + 1) % 3, v = (axis + 2) % 3;
+        const bool negative = face & 1;
+
+        table->clear();
+        plane_keys.clear();
+        planes.clear();
+
+        for (int cv = 1; cv <= S; cv++) {
+            for (int cu = 1; cu <= S; cu++) {
+                const uint64_t column = columns[axis][cv * P + cu];
+                const uint64_t filled = column & 0xffffffff;
+                const uint64_t opaque = column >> 32;
+                const uint64_t clear = filled & ~opaque;
+
+                // the neighbour of bit k is bit k + 1 on positive faces
+                const uint64_t covered = negative ? opaque << 1 : opaque >> 1;
+                const uint64_t see_through = negative ? clear << 1 : clear >> 1;
+                uint64_t faces = filled & ~covered & inner;
+
+                int pos[3];
+                pos[u] = cu - 1;
+                pos[v] = cv - 1;
+
+                // a see-through neighbour only hides the face if it's the
+                // same block, which needs the ids. rare outside water.
+                for (uint64_t check = faces & see_through; check; check &= check - 1) {
+                    const int k = __builtin_ctzll(check);
+                    pos[axis] = k - 1;
+                    const Block::BlockID block = section.get(pos[0], pos[1], pos[2]);
+                    pos[axis] += negative ? -1 : 1;
+                    if (section.get(pos[0], pos[1], pos[2]) == block)
+                        faces &= ~(uint64_t(1) << k);
+                }
+
+                for (faces >>= 1; faces; faces &= faces - 1) {
+                    const int k = __builtin_ctzll(faces);
+                    pos[axis] = k;
+                    const int tile = Block::tile[face][section.get(pos[0], pos[1], pos[2])];
+                    const uint32_t shade = faceShade(section, face, pos[0], pos[1], pos[2]);
+                    const uint64_t key = uint64_t(k) << 40 | uint64_t(shade) << 8 | uint64_t(tile);
+
+                    int32_t &slot = table->find(key);
+                    if (slot < 0) {
+                        slot = plane_keys.size();
+                        plane_keys.push_back(key | uint64_t(cv - 1) << 48);
+                        planes.resize(plane_keys.size() * S, 0);
+                    }
+                    planes[slot * S + cv - 1] |= uint32_t(1) << (cu - 1);
+                }
+            }
+        }
+
+        for (size_t slot = 0; slot < plane_keys.size(); slot++) {
+            const uint64_t key = plane_keys[slot];
+            const int k = int((key >> 40) & 255), tile = int(key & 255);
+            const uint32_t shade = uint32_t(key >> 8);
+            uint32_t *rows = &planes[slot * S];
+
+            for (int j = int(key >> 48); j < S; j++) {
+                while (rows[j]) {
+                    // lowest run of set bits in the row, then as many
+                    // following rows as contain the whole run
+                    const int start = __builtin_ctz(rows[j]);
+                    const int w = __builtin_ctz(~(rows[j] >> start));
+                    const uint32_t run = ((uint32_t(1) << w) - 1) << start;
+
+                    int h = 1;
+                    for (; j + h < S && (rows[j + h] & run) == run; h++)
+                        rows[j + h] &= ~run;
+                    rows[j] &= ~run;
+
+                    emitQuad(mesh, face, k, start, j, w, h, tile, shade);
+                }
+            }
+        }
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+void culledMesh(const PaddedSection &section, ChunkMesh &mesh) {
+    static const int offset[Block::FACE_COUNT][3] = {
+        { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 }
+    };
+
+    mesh.clear();
+
+    for (int y = 0; y < SECTION_SIZE; y++) {
+        for (int z = 0; z < SECTION_SIZE; z++) {
+            for (int x = 0; x < SECTION_SIZE; x++) {
+                const Block::BlockID block = section.get(x, y, z);
+                if (block == Block::AIR)
+                    continue;
+
+                for (int face = 0; face < Block::FACE_COUNT; face++) {
+                    const Block::BlockID neighbour = section.get(x + offset[face][0],
+                                                                 y + offset[face][1],
+                                                                 z + offset[face][2]);
+                    if (!Block::isFaceVisible(block, neighbour))
+                        continue;
+
+                    const int pos[3] = { x, y, z };
+                    const int axis = face >> 1;
+                    emitQuad(mesh, face, pos[axis], pos[(axis + 1) % 3], pos[(axis + 2) % 3], 1, 1,
+                             Block::tile[face][block], faceShade(section, face, x, y, z));
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,252 @@
+#include "../include/noise.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define NOISE_SIMD 1
+#endif
+
+// contracting a * b + c into one fused instruction (when building for a cpu
+// with fma) would round differently on some paths than others
+#pragma GCC optimize("fp-contract=off")
+
+/* -------------------------------------------------------------------------- */
+// one point at a time, also used to finish off what the wide paths leave
+namespace scalar {
+
+typedef float F;
+typedef uint32_t I;
+static const size_t WIDTH = 1;
+
+static inline F load(const float *p) { return *p; }
+static inline void store(float *p, F v) { *p = v; }
+static inline F set(float v) { return v; }
+static inline I seti(uint32_t v) { return v; }
+
+static inline F add(F a, F b) { return a + b; }
+static inline F sub(F a, F b) { return a - b; }
+static inline F mul(F a, F b) { return a * b; }
+static inline I addi(I a, I b) { return a + b; }
+static inline I muli(I a, I b) { return a * b; }
+static inline I andi(I a, I b) { return a & b; }
+static inline I xori(I a, I b) { return a ^ b; }
+static inline I slli(I a, int n) { return a << n; }
+static inline I srli(I a, int n) { return a >> n; }
+
+static inline I truncate(F v) { return uint32_t(int32_t(v)); }
+static inline F tofloat(I v) { return float(int32_t(v)); }
+
+// comparisons give all ones or all zeros, like the vector compares
+static inline I cmpgt(F a, F b) { return a > b ? 0xFFFFFFFF : 0; }
+static inline I cmplt(I a, I b) { return int32_t(a) < int32_t(b) ? 0xFFFFFFFF : 0; }
+static inline I cmpeq(I a, I b) { return a == b ? 0xFFFFFFFF : 0; }
+static inline F select(I mask, F a, F b) { return mask ? a : b; }
+
+static inline F xorf(F v, I bits) {
+    uint32_t u;
+    memcpy(&u, &v, sizeof(u));
+    u ^= bits;
+    memcpy(&v, &u, sizeof(v));
+    return v;
+}
+
+#include "../include/noise_kernel.hpp"
+
+}
+
+#ifdef NOISE_SIMD
+
+/* -------------------------------------------------------------------------- */
+// four points at a time. SSE2 has no 32 bit multiply, so it is built from
+// two 32 x 32 -> 64 multiplies of the even and odd lanes
+#pragma GCC push_options
+#pragma GCC target("sse2")
+namespace sse2 {
+
+typedef __m128 F;
+typedef __m128i I;
+static const size_t WIDTH = 4;
+
+static inline F load(const float *p) { return _mm_loadu_ps(p); }
+static inline void store(float *p, F v) { _mm_storeu_ps(p, v); }
+static inline F set(float v) { return _mm_set1_ps(v); }
+static inline I seti(uint32_t v) { return _mm_set1_epi32(int32_t(v)); }
+
+static inline F add(F a, F b) { return _mm_add_ps(a, b); }
+static inline F sub(F a, F b) { return _mm_sub_ps(a, b); }
+static inline F mul(F a, F b) { return _mm_mul_ps(a, b); }
+static inline I addi(I a, I b) { return _mm_add_epi32(a, b); }
+static inline I andi(I a, I b) { return _mm_and_si128(a, b); }
+static inline I xori(I a, I b) { return _mm_xor_si128(a, b); }
+static inline I slli(I a, int n) { return _mm_slli_epi32(a, n); }
+static inline I srli(I a, int n) { return _mm_srli_epi32(a, n); }
+
+static inline I muli(I a, I b) {
+    const I even = _mm_mul_epu32(a, b);
+    const I odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+static inline I truncate(F v) { return _mm_cvttps_epi32(v); }
+static inline F tofloat(I v) { return _mm_cvtepi32_ps(v); }
+
+static inline I cmpgt(F a, F b) { return _mm_castps_si128(_mm_cmpgt_ps(a, b)); }
+static inline I cmplt(I a, I b) { return _mm_cmplt_epi32(a, b); }
+static inline I cmpeq(I a, I b) { return _mm_cmpeq_epi32(a, b); }
+
+static inline F select(I mask, F a, F b) {
+    const F m = _mm_castsi128_ps(mask);
+    return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b));
+}
+
+static inline F xorf(F v, I bits) { return _mm_xor_ps(v, _mm_castsi128_ps(bits)); }
+
+#include "../include/noise_kernel.hpp"
+
+}
+
+/* -------------------------------------------------------------------------- */
+// eight points at a time. fma is left off on purpose: a fused multiply-add
+// rounds once instead of twice and would change the terrain
+#pragma GCC target("avx2")
+namespace avx2 {
+
+typedef __m256 F;
+typedef __m256i I;
+static const size_t WIDTH = 8;
+
+static inline F load(const float *p) { return _mm256_loadu_ps(p); }
+static inline void store(float *p, F v) { _mm256_storeu_ps(p, v); }
+static inline F set(float v) { return _mm256_set1_ps(v); }
+static inline I seti(uint32_t v) { return _mm256_set1_epi32(int32_t(v)); }
+
+static inline F add(F a, F b) { return _mm256_add_ps(a, b); }
+static inline F sub(F a, F b) { return _mm256_sub_ps(a, b); }
+static inline F mul(F a, F b) { return _mm256_mul_ps(a, b); }
+static inline I addi(I a, I b) { return _mm256_add_epi32(a, b); }
+static inline I muli(I a, I b) { return _mm256_mullo_epi32(a, b); }
+static inline I andi(I a, I b) { return _mm256_and_si256(a, b); }
+static inline I xori(I a, I b) { return _mm256_xor_si256(a, b); }
+static inline I slli(I a, int n) { return _mm256_slli_epi32(a, n); }
+static inline I srli(I a, int n) { return _mm256_srli_epi32(a, n); }
+
+static inline I truncate(F v) { return _mm256_cvttps_epi32(v); }
+static inline F tofloat(I v) { return _mm256_cvtepi32_ps(v); }
+
+static inline I cmpgt(F a, F b) { return _mm256_castps_si256(_mm256_cmp_ps(a, b, _CMP_GT_OQ)); }
+static inline I cmplt(I a, I b) { return _mm256_cmpgt_epi32(b, a); }
+static inline I cmpeq(I a, I b) { return _mm256_cmpeq_epi32(a, b); }
+
+static inline F select(I mask, F a, F b) { return _mm256_blendv_ps(b, a, _mm256_castsi256_ps(mask)); }
+
+static inline F xorf(F v, I bits) { return _mm256_xor_ps(v, _mm256_castsi256_ps(bits)); }
+
+#include "../include/noise_kernel.hpp"
+
+}
+#pragma GCC pop_options
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+typedef size_t (*Kernel2)(const float *, const float *, size_t, uint32_t, float, float, float *);
+typedef size_t (*Kernel3)(const float *, const float *, const float *, size_t, uint32_t, float, float, float *);
+
+struct Kernels {
+    Kernel2 add2;
+    Kernel3 add3;
+};
+
+#ifdef NOISE_SIMD
+static const Kernels kernels[Noise::PATH_COUNT] = {
+    { scalar::add2, scalar::add3 },
+    { sse2::add2, sse2::add3 },
+    { avx2::add2, avx2::add3 }
+};
+#else
+static const Kernels kernels[Noise::PATH_COUNT] = {
+    { scalar::add2, scalar::add3 },
+    { scalar::add2, scalar::add3 },
+    { scalar::add2, scalar::add3 }
+};
+#endif
+
+static Noise::Path current = Noise::best();
+
+Noise::Path Noise::best() {
+#ifdef NOISE_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return AVX2;
+    if (__builtin_cpu_supports("sse2"))
+        return SSE2;
+#endif
+    return SCALAR;
+}
+
+Noise::Path Noise::path() {
+    return current;
+}
+
+Noise::Path Noise::setPath(Path path) {
+    const Path widest = best();
+    current = path < widest ? path : widest;
+    return current;
+}
+
+const char *Noise::name(Path path) {
+    static const char *const names[PATH_COUNT] = { "scalar", "sse2", "avx2" };
+    return names[path];
+}
+
+void Noise::add2(const float *x, const float *y, size_t count, uint32_t seed,
+                 float frequency, float amplitude, float *out) {
+    const size_t done = kernels[current].add2(x, y, count, seed, frequency, amplitude, out);
+    scalar::add2(x + done, y + done, count - done, seed, frequency, amplitude, out + done);
+}
+
+void Noise::add3(const float *x, const float *y, const float *z, size_t count, uint32_t seed,
+                 float frequency, float amplitude, float *out) {
+    const size_t done = kernels[current].add3(x, y, z, count, seed, frequency, amplitude, out);
+    scalar::add3(x + done, y + done, z + done, count - done, seed, frequency, amplitude, out + done);
+}
+
+// amplitudes of every octave, so the sum can be scaled back to [-1, 1]
+static float octaveTotal(int octaves, float gain) {
+    float total = 0.0f, amplitude = 1.0f;
+    for (int o = 0; o < octaves; o++) {
+        total += amplitude;
+        amplitude *= gain;
+    }
+    return total;
+}
+
+// octaves get unrelated seeds so their lattices don't line up
+static inline uint32_t octaveSeed(uint32_t seed, int octave) {
+    return seed + uint32_t(octave) * 0x9E3779B9;
+}
+
+void Noise::fractal2(const float *x, const float *y, size_t count, uint32_t seed,
+                     float frequency, int octaves, float gain, float *out) {
+    std::fill(out, out + count, 0.0f);
+    float amplitude = 1.0f / octaveTotal(octaves, gain);
+    for (int o = 0; o < octaves; o++) {
+        add2(x, y, count, octaveSeed(seed, o), frequency, amplitude, out);
+        frequency *= 2.0f;
+        amplitude *= gain;
+    }
+}
+
+void Noise::fractal3(const float *x, const float *y, const float *z, size_t count, uint32_t seed,
+                     float frequency, int octaves, float gain, float *out) {
+    std::fill(out, out + count, 0.0f);
+    float amplitude = 1.0f / octaveTotal(octaves, gain);
+    for (int o = 0; o < octaves; o++) {
+        add3(x, y, z, count, octaveSeed(seed, o), frequency, amplitude, out);
+        frequency *= 2.0f;
+        amplitude *= gain;
+    }
+}
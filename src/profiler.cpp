@@ -0,0 +1,287 @@
+#include "../include/profiler.hpp"
+#include "../include/config.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+
+struct ProfileName {
+    std::string name;
+    bool counter;
+};
+
+// function-local so zones registered during static initialization are safe
+struct ProfilerState {
+    std::mutex mutex;
+    std::vector<ProfileName> names;
+    std::vector<std::unique_ptr<ProfileBuffer>> buffers;
+
+    // main thread only: totals for the frame in progress, and the last
+    // PROFILER_HISTORY frame totals per id
+    std::vector<uint64_t> totals;
+    std::vector<std::vector<double>> history;
+    uint64_t frames = 0;
+
+    // events kept for a trace capture, with the thread each came from
+    uint32_t capture_frames = 0;
+    uint64_t capture_start = 0;
+    std::string capture_path;
+    std::vector<ProfileEvent> captured;
+    std::vector<uint32_t> captured_threads;
+    // each thread's dropped count when the capture started
+    std::vector<uint64_t> capture_dropped;
+};
+
+static ProfilerState &state() {
+    static ProfilerState state;
+    return state;
+}
+
+static uint16_t registerName(const char *name, bool counter) {
+    ProfilerState &s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+
+    for (size_t i = 0; i < s.names.size(); i++) {
+        if (s.names[i].counter == counter && s.names[i].name == name)
+            return i;
+    }
+    s.names.push_back({ name, counter });
+    return s.names.size() - 1;
+}
+
+uint16_t Profiler::zone(const char *name) {
+    return registerName(name, false);
+}
+
+uint16_t Profiler::counter(const char *name) {
+    return registerName(name, true);
+}
+
+ProfileBuffer *registerProfileThread() {
+    ProfilerState &s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+
+    s.buffers.emplace_back(new ProfileBuffer());
+    ProfileBuffer *buffer = s.buffers.back().get();
+    buffer->thread_index = s.buffers.size() - 1;
+    buffer->thread_name = "thread " + std::to_string(buffer->thread_index);
+    return buffer;
+}
+
+void Profiler::setThreadName(const std::string &name) {
+    if (!profile_thread_buffer)
+        profile_thread_buffer = registerProfileThread();
+
+    std::lock_guard<std::mutex> lock(state().mutex);
+    profile_thread_buffer->thread_name = name;
+}
+
+void Profiler::endFrame() {
+    ProfilerState &s = state();
+    std::unique_lock<std::mutex> lock(s.mutex);
+
+    s.totals.resize(s.names.size(), 0);
+    s.history.resize(s.names.size());
+
+    for (auto &buffer : s.buffers) {
+        const uint64_t head = buffer->head.load(std::memory_order_acquire);
+        for (uint64_t i = buffer->tail.load(std::memory_order_relaxed); i < head; i++) {
+            const ProfileEvent &event = buffer->events[i & (ProfileBuffer::CAPACITY - 1)];
+            s.totals[event.id] += event.kind == ProfileEvent::ZONE ? event.end - event.start : event.end;
+
+            if (s.capture_frames != 0) {
+                s.captured.push_back(event);
+                s.captured_threads.push_back(buffer->thread_index);
+            }
+        }
+        buffer->tail.store(head, std::memory_order_release);
+    }
+
+    const size_t slot = s.frames % PROFILER_HISTORY;
+    for (size_t id = 0; id < s.names.size(); id++) {
+        std::vector<double> &history = s.history[id];
+        // a zone first seen now has no earlier frames, count them as zero
+        if (history.empty())
+            history.assign(std::min<uint64_t>(s.frames, PROFILER_HISTORY), 0.0);
+
+        const double value = s.names[id].counter ? s.totals[id] : s.totals[id] / 1e6;
+        if (history.size() < PROFILER_HISTORY)
+            history.push_back(value);
+        else
+            history[slot] = value;
+        s.totals[id] = 0;
+    }
+    s.frames++;
+
+    if (s.capture_frames != 0 && --s.capture_frames == 0) {
+        std::vector<ProfileEvent> events;
+        std::vector<uint32_t> threads;
+        events.swap(s.captured);
+        threads.swap(s.captured_threads);
+        // threads that started during the capture dropped nothing before
+        std::vector<uint64_t> dropped(s.buffers.size());
+        for (size_t i = 0; i < s.buffers.size(); i++) {
+            const uint64_t before = i < s.capture_dropped.size() ? s.capture_dropped[i] : 0;
+            dropped[i] = s.buffers[i]->dropped.load(std::memory_order_relaxed) - before;
+        }
+        const std::string path = s.capture_path;
+        const uint64_t origin = s.capture_start;
+        lock.unlock();
+
+        std::ofstream out(path);
+        if (out) {
+            Profiler::writeTrace(out, events, threads, origin, dropped);
+            std::cout << "Wrote " << events.size() << " trace events to " << path << std::endl;
+        } else {
+            std::cout << "ERROR::PROFILER::COULD_NOT_WRITE_TRACE " << path << std::endl;
+        }
+    }
+}
+
+void Profiler::startCapture(uint32_t frames, const std::string &path) {
+    ProfilerState &s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+
+    s.capture_frames = frames;
+    s.capture_start = monotonicNs();
+    s.capture_path = path;
+    s.captured.clear();
+    s.captured_threads.clear();
+    s.capture_dropped.clear();
+    for (auto &buffer : s.buffers)
+        s.capture_dropped.push_back(buffer->dropped.load(std::memory_order_relaxed));
+}
+
+bool Profiler::capturing() {
+    ProfilerState &s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    return s.capture_frames != 0;
+}
+
+static void writeJsonString(std::ostream &out, const std::string &text) {
+    out << '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\')
+            out << '\\';
+        out << c;
+    }
+    out << '"';
+}
+
+void Profiler::writeTrace(std::ostream &out, const std::vector<ProfileEvent> &events,
+                          const std::vector<uint32_t> &threads, uint64_t origin_ns,
+                          const std::vector<uint64_t> &dropped) {
+    ProfilerState &s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    // thread names first, so the timeline rows read main, worker 0, ...
+    for (size_t i = 0; i < s.buffers.size(); i++) {
+        out << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << i << ",\"args\":{\"name\":";
+        writeJsonString(out, s.buffers[i]->thread_name);
+        out << "}},\n";
+    }
+
+    // one series per thread, written even when nothing was lost so a clean
+    // trace says so
+    out << "{\"name\":\"profiler dropped events\",\"ph\":\"C\",\"ts\":0,\"pid\":1,\"tid\":0,\"args\":{";
+    for (size_t i = 0; i < s.buffers.size(); i++) {
+        out << (i ? "," : "");
+        writeJsonString(out, s.buffers[i]->thread_name);
+        out << ":" << (i < dropped.size() ? dropped[i] : 0);
+    }
+    out << "}}" << (events.empty() ? "\n" : ",\n");
+
+    // timestamps are microseconds. events that started before the capture
+    // began are clamped to its start
+    for (size_t i = 0; i < events.size(); i++) {
+        const ProfileEvent &event = events[i];
+        const double start = event.start > origin_ns ? (event.start - origin_ns) / 1e3 : 0.0;
+
+        out << "{\"name\":";
+        writeJsonString(out, s.names[event.id].name);
+        if (event.kind == ProfileEvent::ZONE) {
+            out << ",\"ph\":\"X\",\"ts\":" << start << ",\"dur\":" << (event.end - event.start) / 1e3;
+        } else {
+            out << ",\"ph\":\"C\",\"ts\":" << start << ",\"args\":{\"value\":" << event.end << "}";
+        }
+        out << ",\"pid\":1,\"tid\":" << threads[i] << "}";
+        out << (i + 1 < events.size() ? ",\n" : "\n");
+    }
+
+    out << "]}" << std::endl;
+    out << std::defaultfloat;
+}
+
+std::vector<ProfileStats> Profiler::stats() {
+    ProfilerState &s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+
+    std::vector<ProfileStats> stats;
+    if (s.frames == 0)
+        return stats;
+
+    const size_t last = (s.frames - 1) % PROFILER_HISTORY;
+    for (size_t id = 0; id < s.history.size(); id++) {
+        std::vector<double> values = s.history[id];
+        if (values.empty())
+            continue;
+
+        ProfileStats zone;
+        zone.name = s.names[id].name;
+        zone.counter = s.names[id].counter;
+        zone.last = values[std::min(last, values.size() - 1)];
+
+        double sum = 0;
+        for (double value : values)
+            sum += value;
+        zone.avg = sum / values.size();
+
+        std::sort(values.begin(), values.end());
+        zone.min = values.front();
+        zone.p99 = values[std::min(values.size() - 1, values.size() * 99 / 100)];
+        stats.push_back(zone);
+    }
+    return stats;
+}
+
+void Profiler::print(std::ostream &out) {
+    const std::vector<ProfileStats> stats = Profiler::stats();
+
+    out << std::fixed << std::setprecision(3);
+    out << std::left << std::setw(24) << "per frame (ms / count)"
+        << std::right << std::setw(10) << "last" << std::setw(10) << "min"
+        << std::setw(10) << "avg" << std::setw(10) << "p99" << std::endl;
+
+    // zones first, then counters
+    for (int pass = 0; pass < 2; pass++) {
+        for (const ProfileStats &zone : stats) {
+            if (zone.counter != (pass == 1))
+                continue;
+            out << std::left << std::setw(24) << zone.name << std::right
+                << std::setw(10) << zone.last << std::setw(10) << zone.min
+                << std::setw(10) << zone.avg << std::setw(10) << zone.p99 << std::endl;
+        }
+    }
+    out << std::defaultfloat;
+
+    // zones and counters above are missing whatever full buffers dropped
+    out << std::left << std::setw(24) << "events dropped" << std::right
+        << std::setw(10) << Profiler::dropped() << std::endl;
+}
+
+uint64_t Profiler::dropped() {
+    ProfilerState &s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+
+    uint64_t dropped = 0;
+    for (auto &buffer : s.buffers)
+        dropped += buffer->dropped.load(std::memory_order_relaxed);
+    return dropped;
+}
@@ -0,0 +1,140 @@
+#include "../include/program_cache.hpp"
+#include "../include/config.hpp"
+
+#include <GLFW/glfw3.h>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+// from GL 4.1 / ARB_get_program_binary, missing from the 3.3 glad header
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+
+typedef void (APIENTRYP GetProgramBinaryProc)(GLuint, GLsizei, GLsizei *, GLenum *, void *);
+typedef void (APIENTRYP ProgramBinaryProc)(GLuint, GLenum, const void *, GLsizei);
+typedef void (APIENTRYP ProgramParameteriProc)(GLuint, GLenum, GLint);
+
+static GetProgramBinaryProc getProgramBinary = nullptr;
+static ProgramBinaryProc programBinary = nullptr;
+static ProgramParameteriProc programParameteri = nullptr;
+
+// written at the start of every cache file, bumped if the layout changes
+static const uint32_t cache_magic = 0x50524731;
+
+/* -------------------------------------------------------------------------- */
+// 64-bit FNV-1a, continued from hash
+static uint64_t hashBytes(uint64_t hash, const std::string &bytes) {
+    for (unsigned char c : bytes)
+        hash = (hash ^ c) * 1099511628211ull;
+    // separator, so ("ab", "c") and ("a", "bc") hash differently
+    return (hash ^ 0xFF) * 1099511628211ull;
+}
+
+static std::string glString(GLenum name) {
+    const GLubyte *value = glGetString(name);
+    return value ? (const char *)value : "";
+}
+
+static std::string cachePath(uint64_t key) {
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)key);
+    return std::string(SHADER_CACHE_DIR) + "/" + name;
+}
+
+/* -------------------------------------------------------------------------- */
+bool ProgramCache::supported() {
+    static int state = -1;
+    if (state < 0) {
+        state = 0;
+        if (GLVersion.major > 4 || (GLVersion.major == 4 && GLVersion.minor >= 1)
+         || glfwExtensionSupported("GL_ARB_get_program_binary")) {
+            getProgramBinary = (GetProgramBinaryProc)glfwGetProcAddress("glGetProgramBinary");
+            programBinary = (ProgramBinaryProc)glfwGetProcAddress("glProgramBinary");
+            programParameteri = (ProgramParameteriProc)glfwGetProcAddress("glProgramParameteri");
+
+            // some drivers expose the entry points but no binary formats
+            GLint formats = 0;
+            glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+            state = getProgramBinary && programBinary && programParameteri && formats > 0;
+        }
+    }
+    return state == 1;
+}
+
+uint64_t ProgramCache::key(const std::string &vertex, const std::string &fragment,
+                           const std::string &defines) {
+    uint64_t hash = 14695981039346656037ull;
+    hash = hashBytes(hash, vertex);
+    hash = hashBytes(hash, fragment);
+    hash = hashBytes(hash, defines);
+    hash = hashBytes(hash, glString(GL_VENDOR));
+    hash = hashBytes(hash, glString(GL_RENDERER));
+    hash = hashBytes(hash, glString(GL_VERSION));
+    return hash;
+}
+
+GLuint ProgramCache::load(uint64_t key) {
+    if (!supported())
+        return 0;
+
+    std::ifstream file(cachePath(key), std::ios::binary);
+    if (!file)
+        return 0;
+
+    uint32_t magic = 0, format = 0, length = 0;
+    file.read((char *)&magic, sizeof(magic));
+    file.read((char *)&format, sizeof(format));
+    file.read((char *)&length, sizeof(length));
+    if (!file || magic != cache_magic)
+        return 0;
+
+    std::vector<char> binary(length);
+    file.read(binary.data(), length);
+    if (!file)
+        return 0;
+
+    GLuint program = glCreateProgram();
+    programBinary(program, format, binary.data(), length);
+
+    // the driver may refuse a binary it wrote itself, e.g. after an update
+    // that kept the version string
+    GLint success = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+void ProgramCache::prepare(GLuint program) {
+    if (supported())
+        programParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+}
+
+void ProgramCache::save(uint64_t key, GLuint program) {
+    if (!supported())
+        return;
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    getProgramBinary(program, length, NULL, &format, binary.data());
+
+    std::error_code error;
+    std::filesystem::create_directories(SHADER_CACHE_DIR, error);
+
+    std::ofstream file(cachePath(key), std::ios::binary | std::ios::trunc);
+    const uint32_t header[3] = { cache_magic, (uint32_t)format, (uint32_t)length };
+    file.write((const char *)header, sizeof(header));
+    file.write(binary.data(), length);
+    if (!file)
+        std::cout << "ERROR::SHADER::COULD_NOT_WRITE_PROGRAM_CACHE " << cachePath(key) << std::endl;
+}
@@ -0,0 +1,225 @@
+#include "../include/terrain.hpp"
+#include "../include/noise.hpp"
+
+#include <algorithm>
+
+// frequencies are in cycles per block. continents shape the land over
+// hundreds of blocks, detail adds hills on top of them
+static const float CONTINENT_FREQUENCY = 1.0f / 512.0f;
+static const int CONTINENT_OCTAVES = 3;
+static const float CONTINENT_HEIGHT = 30.0f;
+static const float DETAIL_FREQUENCY = 1.0f / 64.0f;
+static const int DETAIL_OCTAVES = 4;
+static const float DETAIL_HEIGHT = 8.0f;
+
+// tunnels run where both cave fields are within CAVE_RADIUS of zero
+static const float CAVE_FREQUENCY = 1.0f / 64.0f;
+static const int CAVE_OCTAVES = 2;
+static const float CAVE_RADIUS = 0.08f;
+// COARSE lattice spacing. a section holds whole cells, so its lattice
+// includes the points on its far faces, which the next section shares
+static const int CELL_X = 4, CELL_Y = 8, CELL_Z = 4;
+static const int LATTICE_X = SECTION_SIZE / CELL_X + 1;
+static const int LATTICE_Y = SECTION_SIZE / CELL_Y + 1;
+static const int LATTICE_Z = SECTION_SIZE / CELL_Z + 1;
+static const int LATTICE_VOLUME = LATTICE_X * LATTICE_Y * LATTICE_Z;
+// nothing is carved below this, so the world keeps a floor
+static const int CAVE_FLOOR = 2;
+// blocks of ground left between a cave and the sea above it
+static const int SEABED_DEPTH = 4;
+
+// dirt (or sand) between the surface block and the stone
+static const int DIRT_DEPTH = 3;
+
+// each field gets its own seed so they don't mirror each other
+static const uint32_t CONTINENT_SALT = 0x3C6EF372;
+static const uint32_t DETAIL_SALT = 0xA54FF53A;
+static const uint32_t CAVE_A_SALT = 0x510E527F;
+static const uint32_t CAVE_B_SALT = 0x9B05688C;
+
+static const int COLUMNS = SECTION_SIZE * SECTION_SIZE;
+
+// per thread scratch, too big for the stack of a worker
+struct Scratch {
+    float x[SECTION_VOLUME], y[SECTION_VOLUME], z[SECTION_VOLUME];
+    float a[SECTION_VOLUME], b[SECTION_VOLUME];
+    Block::BlockID blocks[SECTION_VOLUME];
+};
+
+static thread_local Scratch scratch;
+
+// fills a section from its lattice, laid out x fastest then z then y. the
+// value steps by a constant between lattice points, so each level of the
+// interpolation adds a step instead of recomputing a lerp, and the rows
+// are fixed 16 wide loops the compiler vectorizes
+static void interpolate(const float *lattice, float *out) {
+    const int PLANE = LATTICE_X * LATTICE_Z;
+
+    // the y slice being filled, and how much it moves per block up
+    float plane[PLANE], plane_step[PLANE];
+    for (int ly = 0; ly < LATTICE_Y - 1; ly++) {
+        const float *below = lattice + ly * PLANE, *above = below + PLANE;
+        for (int i = 0; i < PLANE; i++) {
+            plane[i] = below[i];
+            plane_step[i] = (above[i] - below[i]) * (1.0f / CELL_Y);
+        }
+
+        for (int y = ly * CELL_Y; y < (ly + 1) * CELL_Y; y++) {
+            for (int lz = 0; lz < LATTICE_Z - 1; lz++) {
+                // the z row being filled, and how much it moves per block
+                float row[LATTICE_X], row_step[LATTICE_X];
+                for (int lx = 0; lx < LATTICE_X; lx++) {
+                    row[lx] = plane[lz * LATTICE_X + lx];
+                    row_step[lx] = (plane[(lz + 1) * LATTICE_X + lx] - row[lx]) * (1.0f / CELL_Z);
+                }
+
+                for (int z = lz * CELL_Z; z < (lz + 1) * CELL_Z; z++) {
+                    // spread the row over the 16 blocks, each starting at
+                    // its cell's left value and stepping towards the right
+                    float base[SECTION_SIZE], step[SECTION_SIZE];
+                    for (int x = 0; x < SECTION_SIZE; x++) {
+                        base[x] = row[x / CELL_X];
+                        step[x] = (row[x / CELL_X + 1] - row[x / CELL_X]) * (1.0f / CELL_X);
+                    }
+                    float *dst = out + ChunkSection::index(0, y, z);
+                    for (int x = 0; x < SECTION_SIZE; x++)
+                        dst[x] = base[x] + float(x % CELL_X) * step[x];
+
+                    for (int lx = 0; lx < LATTICE_X; lx++)
+                        row[lx] += row_step[lx];
+                }
+            }
+
+            for (int i = 0; i < PLANE; i++)
+                plane[i] += plane_step[i];
+        }
+    }
+}
+
+// surface height of count columns at world x, z
+static void surface(uint32_t seed, const float *x, const float *z, size_t count, float *scratch, int *out) {
+    float *continent = scratch, *detail = scratch + count;
+    Noise::fractal2(x, z, count, seed ^ CONTINENT_SALT, CONTINENT_FREQUENCY, CONTINENT_OCTAVES, 0.5f, continent);
+    Noise::fractal2(x, z, count, seed ^ DETAIL_SALT, DETAIL_FREQUENCY, DETAIL_OCTAVES, 0.5f, detail);
+
+    for (size_t i = 0; i < count; i++) {
+        const int height = TerrainGenerator::SEA_LEVEL + 2
+                         + int(continent[i] * CONTINENT_HEIGHT + detail[i] * DETAIL_HEIGHT);
+        out[i] = std::min(std::max(height, 1), CHUNK_HEIGHT - 2);
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+TerrainGenerator::TerrainGenerator(uint32_t seed, Sampling sampling) {
+    this->seed = seed;
+    this->sampling = sampling;
+}
+
+void TerrainGenerator::generate(Chunk &chunk) const {
+    int heights[COLUMNS];
+    this->heights(chunk.x, chunk.z, heights);
+    const int top = std::max(*std::max_element(heights, heights + COLUMNS), (int)SEA_LEVEL);
+
+    for (int sy = 0; sy < CHUNK_SECTIONS; sy++) {
+        ChunkSection &section = chunk.sections[sy];
+        const int base = sy * SECTION_SIZE;
+        if (base > top) {
+            section.fill(Block::AIR);
+            continue;
+        }
+
+        // layers of each column, top down: grass, dirt, stone, with sand
+        // instead of both near the water and water filling up to sea level
+        for (int y = 0; y < SECTION_SIZE; y++) {
+            const int wy = base + y;
+            for (int c = 0; c < COLUMNS; c++) {
+                const int height = heights[c];
+                const bool shore = height <= SEA_LEVEL + 1;
+                Block::BlockID id = Block::AIR;
+                if (wy < height - DIRT_DEPTH)
+                    id = Block::STONE;
+                else if (wy < height)
+                    id = shore ? Block::SAND : Block::DIRT;
+                else if (wy == height)
+                    id = shore ? Block::SAND : Block::GRASS;
+                else if (wy <= SEA_LEVEL)
+                    id = Block::WATER;
+                scratch.blocks[y * COLUMNS + c] = id;
+            }
+        }
+
+        if (base + SECTION_SIZE > CAVE_FLOOR) {
+            this->caveFields(chunk.x, sy, chunk.z, scratch.a, scratch.b);
+
+            for (int i = 0; i < SECTION_VOLUME; i++) {
+                const Block::BlockID id = scratch.blocks[i];
+                if (id == Block::AIR || id == Block::WATER)
+                    continue;
+
+                const int wy = base + (i >> 8);
+                const int height = heights[i & (COLUMNS - 1)];
+                // keep the sea floor sealed so caves never open under water
+                const int ceiling = height <= SEA_LEVEL + 1 ? height - SEABED_DEPTH : height;
+                if (wy < CAVE_FLOOR || wy > ceiling)
+                    continue;
+
+                const float a = scratch.a[i], b = scratch.b[i];
+                if (a * a + b * b < CAVE_RADIUS * CAVE_RADIUS)
+                    scratch.blocks[i] = Block::AIR;
+            }
+        }
+
+        section.assign(scratch.blocks);
+    }
+}
+
+void TerrainGenerator::caveFields(int32_t cx, int sy, int32_t cz, float *a, float *b) const {
+    const uint32_t seed_a = this->seed ^ CAVE_A_SALT, seed_b = this->seed ^ CAVE_B_SALT;
+
+    if (this->sampling == FULL) {
+        for (int i = 0; i < SECTION_VOLUME; i++) {
+            scratch.x[i] = float(cx * SECTION_SIZE + (i & 15));
+            scratch.z[i] = float(cz * SECTION_SIZE + ((i >> 4) & 15));
+            scratch.y[i] = float(sy * SECTION_SIZE + (i >> 8));
+        }
+        Noise::fractal3(scratch.x, scratch.y, scratch.z, SECTION_VOLUME, seed_a,
+                        CAVE_FREQUENCY, CAVE_OCTAVES, 0.5f, a);
+        Noise::fractal3(scratch.x, scratch.y, scratch.z, SECTION_VOLUME, seed_b,
+                        CAVE_FREQUENCY, CAVE_OCTAVES, 0.5f, b);
+        return;
+    }
+
+    float x[LATTICE_VOLUME], y[LATTICE_VOLUME], z[LATTICE_VOLUME];
+    float lattice_a[LATTICE_VOLUME], lattice_b[LATTICE_VOLUME];
+    int i = 0;
+    for (int ly = 0; ly < LATTICE_Y; ly++) {
+        for (int lz = 0; lz < LATTICE_Z; lz++) {
+            for (int lx = 0; lx < LATTICE_X; lx++, i++) {
+                x[i] = float(cx * SECTION_SIZE + lx * CELL_X);
+                z[i] = float(cz * SECTION_SIZE + lz * CELL_Z);
+                y[i] = float(sy * SECTION_SIZE + ly * CELL_Y);
+            }
+        }
+    }
+    Noise::fractal3(x, y, z, LATTICE_VOLUME, seed_a, CAVE_FREQUENCY, CAVE_OCTAVES, 0.5f, lattice_a);
+    Noise::fractal3(x, y, z, LATTICE_VOLUME, seed_b, CAVE_FREQUENCY, CAVE_OCTAVES, 0.5f, lattice_b);
+    interpolate(lattice_a, a);
+    interpolate(lattice_b, b);
+}
+
+int TerrainGenerator::height(int x, int z) const {
+    const float fx = float(x), fz = float(z);
+    float scratch[2];
+    int height;
+    surface(this->seed, &fx, &fz, 1, scratch, &height);
+    return height;
+}
+
+void TerrainGenerator::heights(int32_t cx, int32_t cz, int *out) const {
+    float x[COLUMNS], z[COLUMNS], scratch[2 * COLUMNS];
+    for (int c = 0; c < COLUMNS; c++) {
+        x[c] = float(cx * SECTION_SIZE + (c & 15));
+        z[c] = float(cz * SECTION_SIZE + (c >> 4));
+    }
+    surface(this->seed, x, z, COLUMNS, scratch, out);
+}
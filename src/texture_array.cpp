@@ -0,0 +1,79 @@
+#include "../include/texture_array.hpp"
+
+#include <algorithm>
+#include <vector>
+
+TextureArray::TextureArray() {
+    this->ID = 0;
+    this->tile_width = 0;
+    this->tile_height = 0;
+    this->layers = 0;
+}
+
+void TextureArray::solid(int layers, uint32_t rgba) {
+    std::vector<uint32_t> texels(layers, rgba);
+    this->allocate(1, 1, layers);
+    this->uploadLayers(0, layers, texels.data());
+    this->finish();
+}
+
+void TextureArray::allocate(int tile_width, int tile_height, int layers) {
+    this->destroy();
+    this->tile_width = tile_width;
+    this->tile_height = tile_height;
+    this->layers = layers;
+
+    glGenTextures(1, &this->ID);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, this->ID);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, tile_width, tile_height, layers,
+                 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+}
+
+void TextureArray::uploadLayers(int first, int count, const void *pixels) {
+    glBindTexture(GL_TEXTURE_2D_ARRAY, this->ID);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, first, this->tile_width, this->tile_height,
+                    count, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+}
+
+void TextureArray::finish() {
+    glBindTexture(GL_TEXTURE_2D_ARRAY, this->ID);
+
+    // mipmaps are built per layer, so tiles never bleed into each other.
+    // magnified texels stay sharp, minified ones blend between mip levels
+    glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+}
+
+void TextureArray::bind(unsigned int unit) const {
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, this->ID);
+}
+
+void TextureArray::destroy() {
+    if (this->ID == 0)
+        return;
+
+    glDeleteTextures(1, &this->ID);
+    this->ID = 0;
+}
+
+void TextureArray::slice(const unsigned char *atlas, int width, int height,
+                         int columns, int rows, unsigned char *out) {
+    const int tile_width = width / columns, tile_height = height / rows;
+    const size_t row_bytes = (size_t)tile_width * 4;
+
+    for (int tile = 0; tile < columns * rows; tile++) {
+        const int left = (tile % columns) * tile_width;
+        const int top = (tile / columns) * tile_height;
+        for (int y = 0; y < tile_height; y++) {
+            const unsigned char *src = atlas + ((size_t)(top + y) * width + left) * 4;
+            std::copy(src, src + row_bytes, out + (tile_height - 1 - y) * row_bytes);
+        }
+        out += row_bytes * tile_height;
+    }
+}
@@ -0,0 +1,174 @@
+#include "../include/texture_loader.hpp"
+#include "../include/profiler.hpp"
+
+#include <stb_image.h>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+TextureLoader::TextureLoader(JobSystem &jobs) : jobs(jobs) {
+    this->decoded = std::make_shared<MpscQueue<DecodedImage>>();
+    this->pool = std::make_shared<PixelPool>();
+    this->next_request = 0;
+    this->pbos[0] = this->pbos[1] = 0;
+    this->pbo_size[0] = this->pbo_size[1] = 0;
+    this->next_pbo = 0;
+}
+
+void TextureLoader::loadArray(const std::string &path, int columns, int rows, Callback done) {
+    const uint32_t request = ++this->next_request;
+    this->waiting.push_back({ request, std::move(done) });
+
+    std::shared_ptr<MpscQueue<DecodedImage>> decoded = this->decoded;
+    std::shared_ptr<PixelPool> pool = this->pool;
+    this->jobs.submit([=] {
+        PROFILE_ZONE("texture decode");
+
+        DecodedImage image;
+        image.request = request;
+        image.ok = false;
+
+        // rows stay top to bottom, stb_image's default, and slice() flips
+        // each tile. nothing may change that global while workers decode
+        int width, height, channels;
+        unsigned char *data = stbi_load(path.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+        if (!data) {
+            std::cout << "ERROR::TEXTURE::FILE_NOT_SUCCESFULLY_READ " << path << std::endl;
+        } else if (width % columns != 0 || height % rows != 0) {
+            std::cout << "ERROR::TEXTURE::ATLAS_NOT_DIVISIBLE_INTO_TILES " << path << std::endl;
+        } else {
+            {
+                std::lock_guard<std::mutex> lock(pool->mutex);
+                if (!pool->free.empty()) {
+                    image.pixels.swap(pool->free.back());
+                    pool->free.pop_back();
+                }
+            }
+            // keeps the pooled capacity, only grows for a bigger image
+            image.pixels.resize((size_t)width * height * 4);
+            TextureArray::slice(data, width, height, columns, rows, image.pixels.data());
+
+            image.ok = true;
+            image.tile_width = width / columns;
+            image.tile_height = height / rows;
+            image.layers = columns * rows;
+        }
+        stbi_image_free(data);
+        decoded->push(std::move(image));
+    });
+}
+
+size_t TextureLoader::update(size_t budget_bytes) {
+    // move newly decoded images into the upload queue
+    DecodedImage image;
+    while (this->decoded->pop(image)) {
+        auto it = std::find_if(this->waiting.begin(), this->waiting.end(),
+            [&](const std::pair<uint32_t, Callback> &w) { return w.first == image.request; });
+        // nobody waits on it any more, but the buffer is still worth keeping
+        if (it == this->waiting.end()) {
+            this->recycle(image.pixels);
+            continue;
+        }
+
+        if (image.ok) {
+            Upload upload;
+            upload.texture.allocate(image.tile_width, image.tile_height, image.layers);
+            upload.image = std::move(image);
+            upload.next_layer = 0;
+            upload.done = std::move(it->second);
+            this->uploads.push_back(std::move(upload));
+        } else {
+            this->recycle(image.pixels);
+        }
+        this->waiting.erase(it);
+    }
+
+    size_t uploaded = 0;
+    // the forced first layer can overshoot the budget, which must then end
+    // the frame rather than wrap the unsigned remainder around
+    while (!this->uploads.empty() && (uploaded == 0 || uploaded < budget_bytes)) {
+        Upload &upload = this->uploads.front();
+        const size_t layer_bytes = (size_t)upload.image.tile_width * upload.image.tile_height * 4;
+        const int remaining = upload.image.layers - upload.next_layer;
+
+        int count = std::min<size_t>(remaining, (budget_bytes - uploaded) / layer_bytes);
+        if (count == 0 && uploaded == 0)
+            count = 1;
+        if (count == 0)
+            break;
+
+        this->streamLayers(upload, count);
+        uploaded += count * layer_bytes;
+
+        if (upload.next_layer == upload.image.layers) {
+            upload.texture.finish();
+            upload.done(upload.texture);
+            this->recycle(upload.image.pixels);
+            this->uploads.pop_front();
+        }
+    }
+    PROFILE_COUNT("texture bytes uploaded", uploaded);
+    return uploaded;
+}
+
+size_t TextureLoader::pending() const {
+    return this->waiting.size() + this->uploads.size();
+}
+
+void TextureLoader::destroy() {
+    for (Upload &upload : this->uploads)
+        upload.texture.destroy();
+    this->uploads.clear();
+    this->waiting.clear();
+
+    if (this->pbos[0] != 0)
+        glDeleteBuffers(2, this->pbos);
+    this->pbos[0] = this->pbos[1] = 0;
+    this->pbo_size[0] = this->pbo_size[1] = 0;
+}
+
+/* -------------------------------------------------------------------------- */
+void TextureLoader::recycle(std::vector<unsigned char> &pixels) {
+    // failed decodes never got a buffer
+    if (pixels.capacity() == 0)
+        return;
+    std::lock_guard<std::mutex> lock(this->pool->mutex);
+    this->pool->free.push_back(std::move(pixels));
+}
+
+// copies the next count layers of upload into a pixel buffer and starts the
+// transfer from there into the texture
+void TextureLoader::streamLayers(Upload &upload, int count) {
+    PROFILE_ZONE("texture upload");
+
+    const size_t layer_bytes = (size_t)upload.image.tile_width * upload.image.tile_height * 4;
+    const size_t bytes = count * layer_bytes;
+
+    if (this->pbos[0] == 0)
+        glGenBuffers(2, this->pbos);
+
+    const int pbo = this->next_pbo;
+    this->next_pbo ^= 1;
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, this->pbos[pbo]);
+
+    // the buffers only ever grow. respecifying the storage orphans whatever
+    // the GPU may still be reading, so the map below never waits on it
+    this->pbo_size[pbo] = std::max(this->pbo_size[pbo], bytes);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, this->pbo_size[pbo], NULL, GL_STREAM_DRAW);
+
+    void *dst = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, bytes,
+                                 GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (dst) {
+        std::memcpy(dst, upload.image.pixels.data() + upload.next_layer * layer_bytes, bytes);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        upload.texture.uploadLayers(upload.next_layer, count, (void *)0);
+    } else {
+        // can't map, fall back to a plain client memory upload
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        upload.texture.uploadLayers(upload.next_layer, count,
+                                    upload.image.pixels.data() + upload.next_layer * layer_bytes);
+    }
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    upload.next_layer += count;
+}
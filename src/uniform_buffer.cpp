@@ -0,0 +1,30 @@
+#include "../include/uniform_buffer.hpp"
+
+UniformBuffer::UniformBuffer() {
+    this->ID = 0;
+    this->size = 0;
+}
+
+void UniformBuffer::create(size_t size, unsigned int binding) {
+    this->destroy();
+    this->size = size;
+
+    glGenBuffers(1, &this->ID);
+    glBindBuffer(GL_UNIFORM_BUFFER, this->ID);
+    glBufferData(GL_UNIFORM_BUFFER, size, NULL, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, binding, this->ID);
+}
+
+void UniformBuffer::update(const void *data, size_t bytes) {
+    glBindBuffer(GL_UNIFORM_BUFFER, this->ID);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, bytes, data);
+}
+
+void UniformBuffer::destroy() {
+    if (this->ID == 0)
+        return;
+
+    glDeleteBuffers(1, &this->ID);
+    this->ID = 0;
+    this->size = 0;
+}
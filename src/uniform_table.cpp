@@ -0,0 +1,72 @@
+#include "../include/uniform_table.hpp"
+
+#include <cstring>
+
+/* -------------------------------------------------------------------------- */
+void UniformTable::insert(const std::string &name, int location) {
+    if ((this->names.size() + 1) * 2 > this->slots.size())
+        this->grow();
+
+    const uint32_t hash = uniformHash(name.c_str());
+    const size_t mask = this->slots.size() - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        Slot &slot = this->slots[i];
+        if (slot.name < 0) {
+            slot.hash = hash;
+            slot.name = this->names.size();
+            slot.location = location;
+            this->names.push_back(name);
+            return;
+        }
+        if (slot.hash == hash && this->names[slot.name] == name) {
+            slot.location = location;
+            return;
+        }
+    }
+}
+
+int UniformTable::find(const char *name) const {
+    if (this->names.empty())
+        return -1;
+
+    const uint32_t hash = uniformHash(name);
+    const size_t mask = this->slots.size() - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        const Slot &slot = this->slots[i];
+        if (slot.name < 0)
+            return -1;
+        if (slot.hash == hash && std::strcmp(this->names[slot.name].c_str(), name) == 0)
+            return slot.location;
+    }
+}
+
+int UniformTable::find(const std::string &name) const {
+    return this->find(name.c_str());
+}
+
+void UniformTable::clear() {
+    this->slots.clear();
+    this->names.clear();
+}
+
+size_t UniformTable::size() const {
+    return this->names.size();
+}
+
+/* -------------------------------------------------------------------------- */
+// doubles the table, reinserting every entry at its new home slot
+void UniformTable::grow() {
+    std::vector<Slot> old;
+    old.swap(this->slots);
+    this->slots.assign(old.empty() ? 16 : old.size() * 2, Slot{ 0, -1, -1 });
+
+    const size_t mask = this->slots.size() - 1;
+    for (const Slot &slot : old) {
+        if (slot.name < 0)
+            continue;
+        size_t i = slot.hash & mask;
+        while (this->slots[i].name >= 0)
+            i = (i + 1) & mask;
+        this->slots[i] = slot;
+    }
+}
@@ -0,0 +1,149 @@
+#include "../include/visibility.hpp"
+
+static_assert(SECTION_SIZE == 16, "the flood fill steps through indices with shifts by 4");
+
+// every pair of faces connected
+static const FaceConnections all_connected = (uint64_t(1) << (Block::FACE_COUNT * Block::FACE_COUNT)) - 1;
+
+// the faces a block at index touches, as a bit per Block::Face
+static inline uint8_t borderFaces(int index) {
+    const int x = index & 15, z = (index >> 4) & 15, y = index >> 8;
+    return (x == 15) << Block::POS_X | (x == 0) << Block::NEG_X
+         | (y == 15) << Block::POS_Y | (y == 0) << Block::NEG_Y
+         | (z == 15) << Block::POS_Z | (z == 0) << Block::NEG_Z;
+}
+
+FaceConnections sectionConnections(const ChunkSection &section) {
+    if (section.isUniform())
+        return Block::isOpaque(section.get(0)) ? 0 : all_connected;
+
+    thread_local Block::BlockID blocks[SECTION_VOLUME];
+    thread_local uint64_t filled[SECTION_VOLUME / 64];
+    thread_local uint16_t stack[SECTION_VOLUME];
+    section.unpack(blocks);
+
+    // opaque blocks start out filled so the search never enters them
+    for (int w = 0; w < SECTION_VOLUME / 64; w++) {
+        uint64_t word = 0;
+        for (int b = 0; b < 64; b++)
+            word |= uint64_t(Block::isOpaque(blocks[w * 64 + b])) << b;
+        filled[w] = word;
+    }
+
+    FaceConnections faces = 0;
+    // only regions touching the border matter, so only seed from there
+    for (int seed = 0; seed < SECTION_VOLUME && faces != all_connected; seed++) {
+        if (borderFaces(seed) == 0 || (filled[seed >> 6] >> (seed & 63)) & 1)
+            continue;
+
+        uint8_t touched = 0;
+        int top = 0;
+        stack[top++] = seed;
+        filled[seed >> 6] |= uint64_t(1) << (seed & 63);
+
+        while (top > 0) {
+            const int index = stack[--top];
+            touched |= borderFaces(index);
+
+            const int x = index & 15, z = (index >> 4) & 15, y = index >> 8;
+            const int next[6] = {
+                x < 15 ? index + 1 : -1,   x > 0 ? index - 1 : -1,
+                y < 15 ? index + 256 : -1, y > 0 ? index - 256 : -1,
+                z < 15 ? index + 16 : -1,  z > 0 ? index - 16 : -1
+            };
+            for (int n : next) {
+                if (n < 0 || (filled[n >> 6] >> (n & 63)) & 1)
+                    continue;
+                filled[n >> 6] |= uint64_t(1) << (n & 63);
+                stack[top++] = n;
+            }
+        }
+
+        for (int a = 0; a < Block::FACE_COUNT; a++) {
+            if (!(touched >> a & 1))
+                continue;
+            for (int b = 0; b < Block::FACE_COUNT; b++) {
+                if (touched >> b & 1)
+                    faces |= uint64_t(1) << (a * Block::FACE_COUNT + b);
+            }
+        }
+    }
+    return faces;
+}
+
+/* -------------------------------------------------------------------------- */
+void VisibilityGraph::set(SectionPos pos, FaceConnections faces) {
+    auto result = this->nodes.insert({ pos, Node{ faces, 0 } });
+    if (!result.second)
+        result.first->second.faces = faces;
+}
+
+void VisibilityGraph::erase(SectionPos pos) {
+    this->nodes.erase(pos);
+}
+
+void VisibilityGraph::clear() {
+    this->nodes.clear();
+}
+
+size_t VisibilityGraph::size() const {
+    return this->nodes.size();
+}
+
+size_t VisibilityGraph::traverse(SectionPos start, const Frustum &frustum) {
+    // a camera above or below the world looks in through the nearest layer
+    if (start.y >= CHUNK_SECTIONS)
+        start.y = CHUNK_SECTIONS - 1;
+    if (start.y < 0)
+        start.y = 0;
+
+    auto first = this->nodes.find(start);
+    this->everything = first == this->nodes.end();
+    if (this->everything)
+        return this->nodes.size();
+
+    this->traversal++;
+    first->second.visited = this->traversal;
+
+    size_t reached = 1;
+    this->queue.clear();
+    this->queue.push_back({ start, all_connected, -1, 0 });
+
+    for (size_t head = 0; head < this->queue.size(); head++) {
+        const Step step = this->queue[head];
+
+        for (int face = 0; face < Block::FACE_COUNT; face++) {
+            // never head back the way the search has already come
+            if (step.directions >> (face ^ 1) & 1)
+                continue;
+            if (step.entered >= 0 && !facesConnected(step.faces, step.entered, face))
+                continue;
+
+            const SectionPos next = step.pos.neighbour(face);
+            auto it = this->nodes.find(next);
+            if (it == this->nodes.end() || it->second.visited == this->traversal)
+                continue;
+
+            const float min[3] = { float(next.x * SECTION_SIZE), float(next.y * SECTION_SIZE),
+                                   float(next.z * SECTION_SIZE) };
+            const float max[3] = { min[0] + SECTION_SIZE, min[1] + SECTION_SIZE,
+                                   min[2] + SECTION_SIZE };
+            if (!frustum.testBox(min, max))
+                continue;
+
+            it->second.visited = this->traversal;
+            reached++;
+            // entered through the face opposite the one we left by
+            this->queue.push_back({ next, it->second.faces, int8_t(face ^ 1),
+                                    uint8_t(step.directions | 1 << face) });
+        }
+    }
+    return reached;
+}
+
+bool VisibilityGraph::reached(SectionPos pos) const {
+    if (this->everything)
+        return true;
+    auto it = this->nodes.find(pos);
+    return it != this->nodes.end() && it->second.visited == this->traversal;
+}
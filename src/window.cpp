@@ -1,12 +1,25 @@
 #include "../include/window.hpp"
 #include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
+#include <cstdio>
+#include <string>
 
-Window::Window() {
+// camera flying speed, in blocks per second
+const float camera_speed = 10.0f;
 
-    this->last_frame = glfwGetTime();
-    this->last_second = glfwGetTime();
+Window::Window() : timestep(TICKS_PER_SECOND, MAX_TICKS_PER_FRAME), terrain(WORLD_SEED), light(world),
+                   meshes(jobs), textures(jobs), streaming(world, light, terrain, jobs) {
+
+    this->last_frame = monotonicNs();
+    this->last_second = this->last_frame;
+    this->frames = this->fps = this->frame_delta = 0;
+    this->ticks = this->tps = 0;
+    this->show_profiler = false;
     this->size = glm::vec2(SCR_WIDTH, SCR_HEIGHT);
+    this->shader = NULL;
+    this->first_mouse = true;
 
     /* Initializing GLFW */
     /* ---------------------------------------------------------------------- */
@@ -47,12 +60,15 @@ Window::Window() {
 
     glfwSetInputMode(this->handle, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
 
-    // // register a callback function for when the window is resized
-    // glfwSetFramebufferSizeCallback(this->handle, framebuffer_size_callback);
-    // // register a callback function for when the mouse is moved
-    // glfwSetCursorPosCallback(this->handle, mouseCallback);
-    // // register a callback function for when the mouse scrolls
-    // glfwSetScrollCallback(this->handle, scrollCallback);
+    // lets the callbacks find their way back to this window
+    glfwSetWindowUserPointer(this->handle, this);
+
+    // register a callback function for when the window is resized
+    glfwSetFramebufferSizeCallback(this->handle, _framebuffer_size_callback);
+    // register a callback function for when the mouse is moved
+    glfwSetCursorPosCallback(this->handle, _mouse_callback);
+    // register a callback function for when the mouse scrolls
+    glfwSetScrollCallback(this->handle, _scroll_callback);
     glfwSetKeyCallback(this->handle, _key_callback);
 
     /* Initializing GLAD */
@@ -72,100 +88,323 @@ Window::Window() {
 void Window::windowLoop() {
     this->init();
 
-    while (!glfwWindowShouldClose(this->handle)) {
-        const uint64_t now = glfwGetTime();
+    // don't owe the simulation the time spent loading
+    this->last_frame = monotonicNs();
+    this->start_time = this->last_frame;
+    this->timestep.reset(this->last_frame);
 
-        this->frame_delta = now - this->last_frame;
-        this->last_frame = now;
+    Profiler::setThreadName("main");
 
-        this->update();
-        this->render();
-        
-        glfwSwapBuffers(this->handle);
-        glfwPollEvents();
+    while (!glfwWindowShouldClose(this->handle)) {
+        const uint64_t now = monotonicNs();
+        {
+            PROFILE_ZONE("frame");
+
+            this->frame_delta = now - this->last_frame;
+            this->last_frame = now;
+
+            // run the simulation at its fixed rate, however fast we're drawing
+            const uint32_t due = this->timestep.advance(now);
+            for (uint32_t i = 0; i < due; i++)
+                this->tick();
+
+            this->update();
+            this->render();
+
+            PROFILE_ZONE("swap");
+            glfwSwapBuffers(this->handle);
+            glfwPollEvents();
+        }
+
+        this->frames++;
+        if (now - this->last_second >= 1000000000) {
+            this->fps = this->frames;
+            this->tps = this->ticks;
+            this->frames = 0;
+            this->ticks = 0;
+            this->last_second = now;
+
+            char title[64];
+            snprintf(title, sizeof(title), "Minecraft-Clone | %d fps | %d tps", (int)this->fps, (int)this->tps);
+            glfwSetWindowTitle(this->handle, title);
+
+            if (this->show_profiler)
+                Profiler::print(std::cout);
+        }
+
+        Profiler::endFrame();
     }
+
+    this->destroy();
 }
 
+// loads shaders and textures and places the camera. the world itself
+// streams in from update()
 void Window::init() {
-    Shader shader("../shaders/shader.vert", "../shaders/shader.frag");
-    
+    this->shader = new Shader("../shaders/shader.vert", "../shaders/shader.frag",
+                              "#define ARENA_BLOCK_VERTICES " + std::to_string(ARENA_BLOCK_VERTICES));
+
+    /* Texture Loading */
+    /* ---------------------------------------------------------------------- */
+
+    // the atlas decodes on the workers, the world draws grey until then
+    this->blocks.solid(256, 0xFF808080);
+    this->loadTextures();
+
+    this->shader->use();
+    this->shader->setInt("blocks", 0);
+    this->shader->setInt("origins", 1);
+
+    this->arena.create(ARENA_VERTICES, ARENA_INDICES);
+
+    this->frame_uniforms.create(sizeof(FrameUniforms), FRAME_UNIFORM_BINDING);
+
+    glEnable(GL_DEPTH_TEST);
+    glEnable(GL_CULL_FACE);
+
+    /* World Setup */
+    /* ---------------------------------------------------------------------- */
+
+    // the world streams in around the camera from the first update(). a few
+    // blocks above the ground at the origin
+    this->camera = Camera(glm::vec3(0.5f, this->terrain.height(0, 0) + 3.0f, 0.5f));
+    this->camera_prev = this->camera.position;
+}
+
+// (re)loads every texture in the background, swapping each in as it arrives
+void Window::loadTextures() {
+    this->textures.loadArray("../img/blocks.png", 16, 16, [this](TextureArray texture) {
+        this->blocks.destroy();
+        this->blocks = texture;
+    });
+}
+
+void Window::destroy() {
+    this->arena.destroy();
+    this->bounds.clear();
+    this->visibility.clear();
+    this->lods.clear();
+
+    this->textures.destroy();
+    this->blocks.destroy();
+    this->frame_uniforms.destroy();
+    delete this->shader;
+    this->shader = NULL;
+
+    glfwTerminate();
+}
+
+// one fixed-length simulation step
+void Window::tick() {
+    PROFILE_ZONE("tick");
+
+    const float step = camera_speed / this->timestep.rate();
+    const glm::vec3 right = glm::normalize(glm::cross(this->camera.front, this->camera.up));
+
+    this->camera_prev = this->camera.position;
+
+    if (glfwGetKey(this->handle, GLFW_KEY_W) == GLFW_PRESS)
+        this->camera.position += step * this->camera.front;
+
+    if (glfwGetKey(this->handle, GLFW_KEY_S) == GLFW_PRESS)
+        this->camera.position -= step * this->camera.front;
+
+    if (glfwGetKey(this->handle, GLFW_KEY_A) == GLFW_PRESS)
+        this->camera.position -= step * right;
+
+    if (glfwGetKey(this->handle, GLFW_KEY_D) == GLFW_PRESS)
+        this->camera.position += step * right;
+
+    if (glfwGetKey(this->handle, GLFW_KEY_SPACE) == GLFW_PRESS)
+        this->camera.position += step * this->camera.up;
+
+    if (glfwGetKey(this->handle, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS)
+        this->camera.position -= step * this->camera.up;
+
+    this->ticks++;
 }
 
 void Window::update() {
-    // TODO
+    PROFILE_ZONE("update");
+
+    // stream chunks in around the camera, and forget everything drawn for
+    // the ones left behind
+    std::vector<ChunkPos> unloaded;
+    this->streaming.update(this->camera.position.x, this->camera.position.y, this->camera.position.z,
+                           this->camera.front.x, this->camera.front.z, unloaded);
+    for (const ChunkPos &chunk : unloaded) {
+        for (int y = 0; y < CHUNK_SECTIONS; y++) {
+            const SectionPos pos = { chunk.x, y, chunk.z };
+            this->meshes.cancel(pos);
+            this->arena.remove(pos);
+            this->bounds.erase(pos);
+            this->visibility.erase(pos);
+            this->lods.erase(pos);
+        }
+    }
+    PROFILE_COUNT("chunks unloaded", unloaded.size());
+    PROFILE_COUNT("chunks queued", this->streaming.queued());
+    PROFILE_COUNT("chunks generating", this->streaming.generating());
+    PROFILE_COUNT("chunks loaded", this->streaming.loaded());
+
+    // sections that crossed a level of detail boundary, and the neighbours
+    // whose seams with them changed, need new meshes
+    std::vector<SectionPos> changed;
+    this->lods.update(this->camera.position.x, this->camera.position.y, this->camera.position.z, changed);
+    for (const SectionPos &pos : changed) {
+        this->world.markDirty(pos);
+        for (int face = 0; face < Block::FACE_COUNT; face++)
+            this->world.markDirty(pos.neighbour(face));
+    }
+    PROFILE_COUNT("lod changes", changed.size());
+
+    // relight around this frame's edits before meshing what they touched
+    const size_t relit = this->light.update();
+    PROFILE_COUNT("relit blocks", relit);
+
+    // hand every section edited since last frame to the mesh workers,
+    // nearest and most in view first
+    for (const SectionPos &pos : this->streaming.takeDirty())
+        this->meshes.schedule(this->world, pos, this->lods.level(pos), this->lods.skirts(pos));
 }
 
 void Window::render() {
+    PROFILE_ZONE("render");
+
     glClearColor(0.5f, 0.8f, 0.9f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    // move finished meshes to the GPU, stopping once the frame's upload
+    // budget is spent so a burst of meshes can't stall the frame
+    {
+        PROFILE_ZONE("upload");
+        const size_t uploaded = this->meshes.drain(UPLOAD_BUDGET_NS, [this](MeshResult &result) {
+            this->arena.upload(result.pos, result.mesh);
+            this->visibility.set(result.pos, result.faces);
+            if (result.mesh.indices.empty())
+                this->bounds.erase(result.pos);
+            else
+                this->bounds.insert(result.pos);
+        });
+        PROFILE_COUNT("meshes uploaded", uploaded);
+    }
+
+    // stream in any textures that finished decoding
+    {
+        PROFILE_ZONE("texture upload");
+        this->textures.update(TEXTURE_UPLOAD_BUDGET);
+    }
+
+    // draw the camera part way between its last two ticks
+    Camera view_camera = this->camera;
+    const float alpha = this->timestep.alpha();
+    view_camera.position = this->camera_prev + (this->camera.position - this->camera_prev) * alpha;
+
+    const glm::mat4 view = view_camera.view();
+    const glm::mat4 projection = view_camera.projection(this->size.x / this->size.y);
+
+    // one upload of the per-frame block serves every program and draw
+    FrameUniforms frame;
+    frame.view = view;
+    frame.projection = projection;
+    frame.camera = glm::vec4(view_camera.position, (monotonicNs() - this->start_time) / 1e9f);
+    this->frame_uniforms.update(&frame, sizeof(frame));
+
+    this->shader->use();
+
+    // skip every section whose bounds are entirely off screen
+    const glm::mat4 clip = projection * view;
+    const Frustum frustum(glm::value_ptr(clip));
+    {
+        PROFILE_ZONE("cull");
+        this->visible.clear();
+        this->bounds.cull(frustum, this->visible);
+        PROFILE_COUNT("sections visible", this->visible.size());
+        PROFILE_COUNT("sections total", this->bounds.size());
+    }
+
+    // then every one walled off from the camera by solid ground
+    {
+        PROFILE_ZONE("occlusion");
+        const glm::vec3 eye = glm::floor(view_camera.position / (float)SECTION_SIZE);
+        const SectionPos start = { int32_t(eye.x), int32_t(eye.y), int32_t(eye.z) };
+        const size_t reached = this->visibility.traverse(start, frustum);
+
+        const size_t in_frustum = this->visible.size();
+        this->visible.erase(std::remove_if(this->visible.begin(), this->visible.end(),
+            [this](const SectionPos &pos) { return !this->visibility.reached(pos); }),
+            this->visible.end());
+        PROFILE_COUNT("sections reached", reached);
+        PROFILE_COUNT("sections occluded", in_frustum - this->visible.size());
+    }
+
+    this->blocks.bind(0);
+    this->arena.bindOrigins(1);
+
+    // every visible section in one call
+    PROFILE_ZONE("draw");
+    const size_t draws = this->arena.draw(this->visible);
+    PROFILE_COUNT("draw calls", draws);
+    PROFILE_COUNT("arena vertex fragmentation %", 100 * this->arena.vertexSpace().fragmentation());
+    PROFILE_COUNT("arena index fragmentation %", 100 * this->arena.indexSpace().fragmentation());
+    PROFILE_COUNT("arena vertex KB", this->arena.vertexSpace().used() * ARENA_BLOCK_VERTICES
+                                     * sizeof(ChunkVertex) / 1024);
 }
 
 /* -------------------------------------------------------------------------- */
-// called upon a key press, triggers camera movement
+// called upon a key press, closes the window on escape and toggles the
+// profiler output on F3. movement keys are polled once per tick in
+// Window::tick()
 void _key_callback(GLFWwindow *handle, int key, int scancode, int action, int mods) {
-    // const float cameraSpeed = 2.5f * deltaTime;
+    Window *window = (Window *)glfwGetWindowUserPointer(handle);
 
     if (glfwGetKey(handle, GLFW_KEY_ESCAPE) == GLFW_PRESS)
         glfwSetWindowShouldClose(handle, true);
-    
-    // if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
-    //     cameraPos += cameraSpeed * cameraFront;
-
-    // if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
-    //     cameraPos -= cameraSpeed * cameraFront;
-
-    // if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
-    //     cameraPos -= glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
 
-    // if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
-    //     cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (key == GLFW_KEY_F3 && action == GLFW_PRESS)
+        window->show_profiler = !window->show_profiler;
 
-    // if (glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS)
-    //     cameraPos += cameraSpeed * cameraUp;
+    // F5 reloads textures from disk without pausing the game
+    if (key == GLFW_KEY_F5 && action == GLFW_PRESS)
+        window->loadTextures();
 
-    // if (glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS)
-    //     cameraPos -= cameraSpeed * cameraUp;
+    // F2 records the next TRACE_FRAMES frames to a new trace file
+    if (key == GLFW_KEY_F2 && action == GLFW_PRESS && !Profiler::capturing()) {
+        static int trace_count = 0;
+        Profiler::startCapture(TRACE_FRAMES, "trace-" + std::to_string(trace_count++) + ".json");
+    }
 }
 
 /* -------------------------------------------------------------------------- */
 // called upon mouse movement, moves camera
-void _mouse_callback(GLFWwindow * window, double xpos, double ypos) {
-    // if (firstMouse) {
-    //     lastX = xpos;
-    //     lastY = ypos;
-    //     firstMouse = false;
-    // }
-
-    // float xoffset = xpos - lastX;
-    // float yoffset = lastY - ypos;
-    // lastX = xpos;
-    // lastY = ypos;
-
-    // const float sensitivity = 0.07f;
-    // xoffset *= sensitivity;
-    // yoffset *= sensitivity;
-
-    // yaw += xoffset;
-    // pitch += yoffset;
-
-    // if (pitch > 89.0f) pitch = 89.0f;
-    // if (pitch < -89.0f) pitch = -89.0f;
+void _mouse_callback(GLFWwindow * handle, double xpos, double ypos) {
+    Window *window = (Window *)glfwGetWindowUserPointer(handle);
+
+    if (window->first_mouse) {
+        window->last_mouse = glm::vec2(xpos, ypos);
+        window->first_mouse = false;
+    }
+
+    float xoffset = xpos - window->last_mouse.x;
+    float yoffset = window->last_mouse.y - ypos;
+    window->last_mouse = glm::vec2(xpos, ypos);
+
+    window->camera.look(xoffset, yoffset);
 }
 
 /* -------------------------------------------------------------------------- */
 // called upon scroll wheel usage, changes fov
-void _scroll_callback(GLFWwindow* window, double xoffset, double yoffset) {
-    // fov -= (float)yoffset;
-    // if (fov < 1.0f)
-    //     fov = 1.0f;
-    // if (fov > 45.0f)
-    //     fov = 45.0f; 
+void _scroll_callback(GLFWwindow* handle, double xoffset, double yoffset) {
+    Window *window = (Window *)glfwGetWindowUserPointer(handle);
+    window->camera.zoom((float)yoffset);
 }
 
 /* -------------------------------------------------------------------------- */
 // called upon window resize, changes the viewport size
-void _framebuffer_size_callback(GLFWwindow * window, int width, int height) {
-    
+void _framebuffer_size_callback(GLFWwindow * handle, int width, int height) {
+    Window *window = (Window *)glfwGetWindowUserPointer(handle);
+    window->size = glm::vec2(width, height);
+
     glViewport(0,       // set the x coord of the lower left corner
                0,       // set the y coord of the lower left corner
                width,   // set the x coord of the upper right corner
@@ -0,0 +1,99 @@
+#include "../include/world.hpp"
+
+static_assert(SECTION_SIZE == 16, "world coordinates are split with shifts by 4");
+
+/* -------------------------------------------------------------------------- */
+SectionPos SectionPos::neighbour(int face) const {
+    SectionPos pos = *this;
+    const int step = (face & 1) ? -1 : 1;
+    switch (face >> 1) {
+        case 0: pos.x += step; break;
+        case 1: pos.y += step; break;
+        case 2: pos.z += step; break;
+    }
+    return pos;
+}
+
+/* -------------------------------------------------------------------------- */
+Chunk *World::getChunk(int32_t x, int32_t z) const {
+    const std::unique_ptr<Chunk> *chunk = this->chunks.find(chunkKey(x, z));
+    return chunk ? chunk->get() : nullptr;
+}
+
+Chunk &World::createChunk(int32_t x, int32_t z) {
+    Chunk *chunk = this->getChunk(x, z);
+    if (chunk)
+        return *chunk;
+    return *this->chunks.insert(chunkKey(x, z), std::unique_ptr<Chunk>(new Chunk(x, z)));
+}
+
+Chunk &World::addChunk(std::unique_ptr<Chunk> chunk) {
+    const uint64_t key = chunkKey(chunk->x, chunk->z);
+    return *this->chunks.insert(key, std::move(chunk));
+}
+
+void World::removeChunk(int32_t x, int32_t z) {
+    this->chunks.erase(chunkKey(x, z));
+}
+
+size_t World::chunkCount() const {
+    return this->chunks.size();
+}
+
+const ChunkSection *World::getSection(SectionPos pos) const {
+    if (pos.y < 0 || pos.y >= CHUNK_SECTIONS)
+        return nullptr;
+
+    const Chunk *chunk = this->getChunk(pos.x, pos.z);
+    return chunk ? &chunk->sections[pos.y] : nullptr;
+}
+
+const LightSection *World::getLight(SectionPos pos) const {
+    if (pos.y < 0 || pos.y >= CHUNK_SECTIONS)
+        return nullptr;
+
+    const Chunk *chunk = this->getChunk(pos.x, pos.z);
+    return chunk ? &chunk->light[pos.y] : nullptr;
+}
+
+// arithmetic shifts floor negative coordinates into the right chunk
+Block::BlockID World::getBlock(int x, int y, int z) const {
+    if (y < 0 || y >= CHUNK_HEIGHT)
+        return Block::AIR;
+
+    const Chunk *chunk = this->getChunk(x >> 4, z >> 4);
+    return chunk ? chunk->get(x & 15, y, z & 15) : Block::AIR;
+}
+
+void World::setBlock(int x, int y, int z, Block::BlockID id) {
+    if (y < 0 || y >= CHUNK_HEIGHT)
+        return;
+
+    Chunk *chunk = this->getChunk(x >> 4, z >> 4);
+    if (!chunk)
+        return;
+
+    chunk->set(x & 15, y, z & 15, id);
+
+    // a block on the section border also shows or hides a face, or shades
+    // a corner, of the sections on the other side
+    forEachSectionTouching(x, y, z, [this](SectionPos pos) { this->markDirty(pos); });
+}
+
+void World::markDirty(SectionPos pos) {
+    if (this->getSection(pos))
+        this->dirty.insert(pos);
+}
+
+void World::markChunkDirty(int32_t x, int32_t z) {
+    for (int y = 0; y < CHUNK_SECTIONS; y++)
+        for (int dz = -1; dz <= 1; dz++)
+            for (int dx = -1; dx <= 1; dx++)
+                this->markDirty({ x + dx, y, z + dz });
+}
+
+std::vector<SectionPos> World::takeDirty() {
+    std::vector<SectionPos> sections(this->dirty.begin(), this->dirty.end());
+    this->dirty.clear();
+    return sections;
+}
@@ -0,0 +1,58 @@
+#include "./test.hpp"
+#include "../include/chunk.hpp"
+
+#include <random>
+#include <set>
+
+// random edits from a few block types, so slots are freed, dropped and
+// claimed again, checked block by block against a plain array
+TEST(chunk_section_matches_array) {
+    std::mt19937 random(3);
+    ChunkSection section;
+    Block::BlockID expected[SECTION_VOLUME];
+    for (Block::BlockID &id : expected)
+        id = Block::AIR;
+
+    const Block::BlockID types[] = { Block::AIR, Block::STONE, Block::DIRT, Block::GRASS, Block::SAND };
+    for (int round = 0; round < 200; round++) {
+        // a few types per round, so the palette grows and shrinks
+        const int count = 1 + round % 4;
+        for (int edit = 0; edit < 500; edit++) {
+            const int index = int(random() % SECTION_VOLUME);
+            const Block::BlockID id = types[random() % count];
+            section.set(index, id);
+            expected[index] = id;
+        }
+
+        std::set<int> distinct;
+        bool same = true;
+        for (int i = 0; i < SECTION_VOLUME; i++) {
+            same &= section.get(i) == expected[i];
+            distinct.insert(expected[i]);
+        }
+        CHECK(same);
+        CHECK_EQ(section.paletteSize(), int(distinct.size()));
+        CHECK_EQ(section.isUniform(), distinct.size() == 1);
+    }
+}
+
+// overwriting the last type added frees the slot at the end of the palette
+TEST(chunk_section_release_last_slot) {
+    ChunkSection section(Block::STONE);
+    section.set(0, Block::DIRT);
+    section.set(1, Block::GRASS);
+    CHECK_EQ(section.paletteSize(), 3);
+
+    section.set(1, Block::STONE);
+    CHECK_EQ(section.paletteSize(), 2);
+    section.set(2, Block::SAND);
+    CHECK_EQ(section.paletteSize(), 3);
+    CHECK_EQ(section.get(0), Block::DIRT);
+    CHECK_EQ(section.get(1), Block::STONE);
+    CHECK_EQ(section.get(2), Block::SAND);
+
+    section.set(0, Block::STONE);
+    section.set(2, Block::STONE);
+    CHECK(section.isUniform());
+    CHECK_EQ(section.get(SECTION_VOLUME - 1), Block::STONE);
+}
@@ -0,0 +1,17 @@
+#include "./test.hpp"
+#include "../include/fixed_timestep.hpp"
+
+// a rate of 0 would divide by zero, and one above a tick a nanosecond would
+// leave ticks 0 ns long
+TEST(fixed_timestep_clamps_rate) {
+    FixedTimestep timestep(0, 5);
+    CHECK_EQ(timestep.rate(), 1u);
+    CHECK_EQ(timestep.tickNs(), uint64_t(1000000000));
+    CHECK_EQ(timestep.advance(2500000000ull), 2u);
+    CHECK(timestep.alpha() > 0.49f && timestep.alpha() < 0.51f);
+
+    timestep.setRate(4000000000u);
+    CHECK_EQ(timestep.tickNs(), uint64_t(1));
+    timestep.reset(0);
+    CHECK_EQ(timestep.advance(3), 3u);
+}
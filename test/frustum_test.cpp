@@ -0,0 +1,80 @@
+#include "./test.hpp"
+#include "../bench/scenes.hpp"
+#include "../include/frustum.hpp"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+static bool lessSection(const SectionPos &a, const SectionPos &b) {
+    if (a.x != b.x)
+        return a.x < b.x;
+    if (a.y != b.y)
+        return a.y < b.y;
+    return a.z < b.z;
+}
+
+// the sections of a list testBox() keeps
+static std::vector<SectionPos> testEach(const Frustum &frustum, const std::vector<SectionPos> &sections) {
+    std::vector<SectionPos> visible;
+    for (const SectionPos &pos : sections) {
+        const float min[3] = { float(pos.x * SECTION_SIZE), float(pos.y * SECTION_SIZE),
+                               float(pos.z * SECTION_SIZE) };
+        const float max[3] = { min[0] + SECTION_SIZE, min[1] + SECTION_SIZE,
+                               min[2] + SECTION_SIZE };
+        if (frustum.testBox(min, max))
+            visible.push_back(pos);
+    }
+    return visible;
+}
+
+// culling whole columns first must keep exactly the sections testing each
+// box would, from cameras looking every way and with gaps in the columns
+TEST(frustum_cull_matches_test_box) {
+    const int radius = 12;
+    std::mt19937 random(5);
+    SectionBounds bounds;
+    std::vector<SectionPos> sections;
+    for (int x = -radius; x < radius; x++) {
+        for (int z = -radius; z < radius; z++) {
+            for (int y = 0; y < CHUNK_SECTIONS; y++) {
+                // a few holes, and a few columns emptied entirely
+                if (random() % 4 == 0 || (x + z) % 7 == 0)
+                    continue;
+                bounds.insert({ x, y, z });
+                sections.push_back({ x, y, z });
+            }
+        }
+    }
+    // erasing what was never inserted changes nothing
+    bounds.erase({ 0, CHUNK_SECTIONS, 0 });
+    bounds.erase({ radius, 0, radius });
+    CHECK_EQ(bounds.size(), sections.size());
+
+    std::uniform_real_distribution<float> angle(-3.14159f, 3.14159f), height(-40.0f, 300.0f);
+    for (int camera = 0; camera < 64; camera++) {
+        float clip[16];
+        cameraMatrix(float(random() % 200) - 100.0f, height(random), float(random() % 200) - 100.0f,
+                     angle(random), angle(random) * 0.5f, clip);
+        const Frustum frustum(clip);
+
+        std::vector<SectionPos> visible;
+        CHECK_EQ(bounds.cull(frustum, visible), visible.size());
+        std::vector<SectionPos> expected = testEach(frustum, sections);
+        std::sort(visible.begin(), visible.end(), lessSection);
+        std::sort(expected.begin(), expected.end(), lessSection);
+        CHECK_EQ(visible.size(), expected.size());
+        CHECK(std::equal(visible.begin(), visible.end(), expected.begin(), expected.end(),
+                         [](const SectionPos &a, const SectionPos &b) {
+                             return a.x == b.x && a.y == b.y && a.z == b.z;
+                         }));
+
+        // drop some sections so columns shrink and empty ones move
+        std::shuffle(sections.begin(), sections.end(), random);
+        for (int i = 0; i < 200 && !sections.empty(); i++) {
+            bounds.erase(sections.back());
+            sections.pop_back();
+        }
+        CHECK_EQ(bounds.size(), sections.size());
+    }
+}
@@ -0,0 +1,90 @@
+#include "./test.hpp"
+#include "../include/job_system.hpp"
+#include "../include/light_engine.hpp"
+#include "../include/terrain.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+// a square of generated, unlit chunks radius chunks around the origin
+struct UnlitWorld {
+    World world;
+    TerrainGenerator terrain;
+    LightEngine light;
+
+    explicit UnlitWorld(int radius) : terrain(1337), light(world) {
+        for (int x = -radius; x < radius; x++)
+            for (int z = -radius; z < radius; z++)
+                this->terrain.generate(this->world.createChunk(x, z));
+    }
+};
+
+static std::vector<ChunkPos> chunksAround(int radius) {
+    std::vector<ChunkPos> chunks;
+    for (int x = -radius; x < radius; x++)
+        for (int z = -radius; z < radius; z++)
+            chunks.push_back({ x, z });
+    return chunks;
+}
+
+// blocks whose sky or block light differs between two worlds of the same
+// chunks
+static size_t mismatchedLight(const World &a, const World &b, int radius) {
+    size_t mismatched = 0;
+    for (const ChunkPos &pos : chunksAround(radius)) {
+        const Chunk *x = a.getChunk(pos.x, pos.z), *y = b.getChunk(pos.x, pos.z);
+        for (int sy = 0; sy < CHUNK_SECTIONS; sy++) {
+            for (int i = 0; i < SECTION_VOLUME; i++) {
+                mismatched += x->light[sy].sky.get(i) != y->light[sy].sky.get(i)
+                           || x->light[sy].block.get(i) != y->light[sy].block.get(i);
+            }
+        }
+    }
+    return mismatched;
+}
+
+// lights a world in parallel and the same world one chunk at a time, then
+// relights random batches (repeats and neighbours included) over edits made
+// to both. every block must come out with the same light. run it through
+// bin/test_tsan as well
+TEST(light_parallel_matches_serial) {
+    const int radius = 4, rounds = 20, batch_size = 24, edits = 8;
+    std::unique_ptr<UnlitWorld> parallel(new UnlitWorld(radius));
+    std::unique_ptr<UnlitWorld> serial(new UnlitWorld(radius));
+    JobSystem jobs(std::max(2u, std::thread::hardware_concurrency()));
+    std::mt19937 random(7);
+
+    std::vector<ChunkPos> chunks = chunksAround(radius);
+    std::shuffle(chunks.begin(), chunks.end(), random);
+    parallel->light.lightChunks(chunks, jobs);
+    for (const ChunkPos &pos : chunks)
+        serial->light.lightChunk(pos.x, pos.z);
+    CHECK_EQ(mismatchedLight(parallel->world, serial->world, radius), size_t(0));
+
+    std::uniform_int_distribution<int> chunk_coord(-radius, radius - 1);
+    std::uniform_int_distribution<int> block_coord(-radius * SECTION_SIZE, radius * SECTION_SIZE - 1);
+    const Block::BlockID placed[] = { Block::AIR, Block::STONE, Block::LAVA };
+    for (int round = 0; round < rounds; round++) {
+        for (int e = 0; e < edits; e++) {
+            const int x = block_coord(random), z = block_coord(random);
+            const int y = serial->terrain.height(x, z) + int(random() % 5) - 2;
+            const Block::BlockID id = placed[random() % 3];
+            for (UnlitWorld *scene : { parallel.get(), serial.get() }) {
+                scene->world.setBlock(x, y, z, id);
+                scene->light.blockChanged(x, y, z);
+                scene->light.update();
+            }
+        }
+
+        std::vector<ChunkPos> batch;
+        for (int i = 0; i < batch_size; i++)
+            batch.push_back({ chunk_coord(random), chunk_coord(random) });
+        parallel->light.lightChunks(batch, jobs);
+        for (const ChunkPos &pos : batch)
+            serial->light.lightChunk(pos.x, pos.z);
+        CHECK_EQ(mismatchedLight(parallel->world, serial->world, radius), size_t(0));
+    }
+}
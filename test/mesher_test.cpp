@@ -0,0 +1,175 @@
+#include "./test.hpp"
+#include "../bench/scenes.hpp"
+#include "../include/mesher.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+static const ChunkSection *const no_neighbours[Block::FACE_COUNT] = {};
+
+typedef void (*Mesher)(const PaddedSection &, ChunkMesh &);
+
+static const Mesher mergingMeshers[] = { greedyMesh, binaryMesh };
+
+// quads mesher gives section with the given face neighbours
+static size_t quads(Mesher mesher, const ChunkSection &section,
+                    const ChunkSection *const neighbours[Block::FACE_COUNT] = no_neighbours) {
+    std::unique_ptr<PaddedSection> padded(new PaddedSection);
+    padded->load(section, neighbours);
+    ChunkMesh mesh;
+    mesher(*padded, mesh);
+    return mesh.quads();
+}
+
+TEST(mesher_single_block) {
+    ChunkSection section;
+    section.set(3, 4, 5, Block::STONE);
+    for (Mesher mesher : mergingMeshers)
+        CHECK_EQ(quads(mesher, section), size_t(6));
+    CHECK_EQ(quads(culledMesh, section), size_t(6));
+}
+
+TEST(mesher_full_section) {
+    const ChunkSection section(Block::STONE);
+    for (Mesher mesher : mergingMeshers)
+        CHECK_EQ(quads(mesher, section), size_t(6));
+    CHECK_EQ(quads(culledMesh, section), size_t(6 * SECTION_SIZE * SECTION_SIZE));
+}
+
+TEST(mesher_buried_section) {
+    const ChunkSection section(Block::STONE);
+    const ChunkSection *const neighbours[Block::FACE_COUNT] = {
+        &section, &section, &section, &section, &section, &section
+    };
+    for (Mesher mesher : mergingMeshers)
+        CHECK_EQ(quads(mesher, section, neighbours), size_t(0));
+    CHECK_EQ(quads(culledMesh, section, neighbours), size_t(0));
+}
+
+// one layer, grass on the low x half and dirt on the other: two tops, one
+// bottom (grass shows dirt underneath), one quad on each x side and two on
+// each z side
+TEST(mesher_two_type_slab) {
+    ChunkSection section;
+    for (int z = 0; z < SECTION_SIZE; z++)
+        for (int x = 0; x < SECTION_SIZE; x++)
+            section.set(x, 0, z, x < SECTION_SIZE / 2 ? Block::GRASS : Block::DIRT);
+    for (Mesher mesher : mergingMeshers)
+        CHECK_EQ(quads(mesher, section), size_t(9));
+}
+
+// a block in the corner of the section shows every face when its
+// neighbours are missing, and hides the ones against a loaded solid one
+TEST(mesher_missing_neighbours_are_air) {
+    ChunkSection section;
+    section.set(SECTION_SIZE - 1, 0, 0, Block::STONE);
+    const ChunkSection air, solid(Block::STONE);
+
+    const ChunkSection *const airy[Block::FACE_COUNT] = { &air, &air, &air, &air, &air, &air };
+    const ChunkSection *beside[Block::FACE_COUNT] = {}, *below[Block::FACE_COUNT] = {};
+    beside[Block::POS_X] = &solid;
+    below[Block::NEG_Y] = &solid;
+    for (Mesher mesher : mergingMeshers) {
+        CHECK_EQ(quads(mesher, section), quads(mesher, section, airy));
+        CHECK_EQ(quads(mesher, section), size_t(6));
+        CHECK_EQ(quads(mesher, section, beside), size_t(5));
+        CHECK_EQ(quads(mesher, section, below), size_t(5));
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+// a mesh as a sorted list of quads, each its two triangles' vertices sorted,
+// so meshes that emit the same quads in another order compare equal. the
+// diagonal each quad is split along stays part of it
+typedef std::vector<std::vector<uint32_t>> QuadSet;
+
+static QuadSet quadSet(const ChunkMesh &mesh) {
+    QuadSet quads;
+    for (size_t i = 0; i + 6 <= mesh.indices.size(); i += 6) {
+        std::vector<uint32_t> triangles[2];
+        for (int t = 0; t < 2; t++) {
+            for (int k = 0; k < 3; k++)
+                triangles[t].push_back(mesh.vertices[mesh.indices[i + 3 * t + k]].data);
+            std::sort(triangles[t].begin(), triangles[t].end());
+        }
+        if (triangles[1] < triangles[0])
+            std::swap(triangles[0], triangles[1]);
+        std::vector<uint32_t> quad = triangles[0];
+        quad.insert(quad.end(), triangles[1].begin(), triangles[1].end());
+        quads.push_back(quad);
+    }
+    std::sort(quads.begin(), quads.end());
+    return quads;
+}
+
+static void checkSameQuads(const PaddedSection &padded) {
+    ChunkMesh greedy, binary;
+    greedyMesh(padded, greedy);
+    binaryMesh(padded, binary);
+    CHECK(greedy.quads() != 0);
+    CHECK_EQ(greedy.quads(), binary.quads());
+    CHECK(quadSet(greedy) == quadSet(binary));
+}
+
+static void randomScene(ChunkSection &section) {
+    fillRandom(section, 7);
+}
+
+static void (*const scenes[])(ChunkSection &) = { randomScene, fillTerrain, fillCheckerboard };
+
+// without neighbours, with and without corner shading
+TEST(mesher_binary_matches_greedy) {
+    for (auto scene : scenes) {
+        ChunkSection section;
+        scene(section);
+        std::unique_ptr<PaddedSection> padded(new PaddedSection);
+        padded->load(section, no_neighbours);
+        checkSameQuads(*padded);
+        padded->smooth = false;
+        checkSameQuads(*padded);
+    }
+}
+
+// inside a neighbourhood of random sections with uneven light, so faces on
+// the border and the shading of their corners come into it
+TEST(mesher_binary_matches_greedy_with_neighbours) {
+    std::mt19937 random(11);
+    for (auto scene : scenes) {
+        ChunkSection sections[PaddedSection::NEIGHBOURHOOD];
+        LightSection light[PaddedSection::NEIGHBOURHOOD];
+        const ChunkSection *section_slots[PaddedSection::NEIGHBOURHOOD];
+        const LightSection *light_slots[PaddedSection::NEIGHBOURHOOD];
+        for (int slot = 0; slot < PaddedSection::NEIGHBOURHOOD; slot++) {
+            if (slot == PaddedSection::around(0, 0, 0))
+                scene(sections[slot]);
+            else
+                fillRandom(sections[slot], random(), 0.3f);
+            for (int i = 0; i < SECTION_VOLUME; i++) {
+                light[slot].sky.set(i, uint8_t(random() % 16));
+                light[slot].block.set(i, uint8_t(random() % 16));
+            }
+            section_slots[slot] = &sections[slot];
+            light_slots[slot] = &light[slot];
+        }
+
+        std::unique_ptr<PaddedSection> padded(new PaddedSection);
+        padded->load(section_slots);
+        padded->loadLight(light_slots);
+        checkSameQuads(*padded);
+    }
+}
+
+// every field of a packed vertex reads back unchanged, bits 18-19 as ao
+TEST(chunk_vertex_round_trip) {
+    const ChunkVertex vertex = ChunkVertex::pack(SECTION_SIZE, 7, 0, Block::NEG_Z, 2, 11, 200);
+    CHECK_EQ(vertex.x(), SECTION_SIZE);
+    CHECK_EQ(vertex.y(), 7);
+    CHECK_EQ(vertex.z(), 0);
+    CHECK_EQ(vertex.face(), int(Block::NEG_Z));
+    CHECK_EQ(vertex.ao(), 2);
+    CHECK_EQ(vertex.light(), 11);
+    CHECK_EQ(vertex.tile(), 200);
+    CHECK_EQ((vertex.data >> 18) & 3u, 2u);
+}
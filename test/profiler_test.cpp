@@ -0,0 +1,38 @@
+#include "./test.hpp"
+#include "../include/profiler.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+// a frame recording more zones than a buffer holds loses the overflow, and
+// says so in the stats table and in the trace of a capture
+TEST(profiler_reports_dropped_events) {
+    const char *path = "profiler_test_trace.json";
+    const uint64_t extra = 10;
+
+    Profiler::endFrame();
+    const uint64_t before = Profiler::dropped();
+    Profiler::startCapture(1, path);
+    for (uint64_t i = 0; i < ProfileBuffer::CAPACITY + extra; i++) {
+        PROFILE_ZONE("test overflow zone");
+    }
+    Profiler::endFrame();
+    CHECK_EQ(Profiler::dropped() - before, extra);
+
+    std::ostringstream table;
+    Profiler::print(table);
+    CHECK(table.str().find("events dropped") != std::string::npos);
+
+    std::ifstream file(path);
+    std::stringstream trace;
+    trace << file.rdbuf();
+    file.close();
+    std::remove(path);
+    const std::string text = trace.str();
+    const size_t counter = text.find("\"profiler dropped events\"");
+    CHECK(counter != std::string::npos);
+    CHECK(text.find(":" + std::to_string(extra) + "}", counter) != std::string::npos
+          || text.find(":" + std::to_string(extra) + ",", counter) != std::string::npos);
+}
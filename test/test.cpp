@@ -0,0 +1,49 @@
+#include "./test.hpp"
+
+#include <cstring>
+#include <vector>
+
+struct Entry {
+    const char *name;
+    test::Function function;
+};
+
+// function-local so registration from other translation units is safe during
+// static initialization
+static std::vector<Entry> &registry() {
+    static std::vector<Entry> entries;
+    return entries;
+}
+
+static int failures = 0;
+
+int test::add(const char *name, test::Function function) {
+    registry().push_back({name, function});
+    return registry().size();
+}
+
+void test::fail(const char *file, int line, const char *expression) {
+    std::cout << "    FAILED " << file << ":" << line << ": " << expression << std::endl;
+    failures++;
+}
+
+// runs every registered test, or only those whose name contains the filter
+// argument. exits non-zero if any check failed
+int main(int argc, char **argv) {
+    const char *filter = argc > 1 ? argv[1] : "";
+
+    int run = 0, failed = 0;
+    for (const Entry &entry : registry()) {
+        if (!strstr(entry.name, filter))
+            continue;
+
+        std::cout << entry.name << std::endl;
+        const int before = failures;
+        entry.function();
+        run++;
+        failed += failures != before;
+    }
+
+    std::cout << run - failed << "/" << run << " tests passed" << std::endl;
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,41 @@
+#ifndef TEST_H
+#define TEST_H
+
+#include <iostream>
+
+namespace test {
+
+typedef void (*Function)();
+
+int add(const char *name, Function function);
+
+// records a failed check against the running test
+void fail(const char *file, int line, const char *expression);
+
+}
+
+// defines and registers a test function
+#define TEST(name) \
+    static void name(); \
+    static int name##_registered = test::add(#name, name); \
+    static void name()
+
+// fails the running test, and carries on with it, if condition is false
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) \
+            test::fail(__FILE__, __LINE__, #condition); \
+    } while (0)
+
+// CHECK(a == b), printing both values when they differ
+#define CHECK_EQ(a, b) \
+    do { \
+        const auto check_a = (a); \
+        const auto check_b = (b); \
+        if (!(check_a == check_b)) { \
+            test::fail(__FILE__, __LINE__, #a " == " #b); \
+            std::cout << "    " << check_a << " != " << check_b << std::endl; \
+        } \
+    } while (0)
+
+#endif